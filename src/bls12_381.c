@@ -20,7 +20,14 @@
  * Wrappers for cryptographic library functions, allowing different libraries to be supported.
  */
 
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // memcmp()
 #include "bls12_381.h"
+#include "parallel.h"
+
+#ifdef __AVX512IFMA__
+#include <immintrin.h>
+#endif
 
 #ifdef BLST
 
@@ -43,19 +50,30 @@ int log_2_byte(byte b) {
     return r;
 }
 
+/**
+ * Compare the limbs of two field elements.
+ *
+ * Blst keeps field elements fully reduced in Montgomery form, so each value has a unique representation and we can
+ * compare the limbs directly without converting them. The comparison is branch-free so that loops over arrays of
+ * elements can be vectorised.
+ *
+ * @param[in] a The first element
+ * @param[in] b The second element
+ * @return `true` if the limbs of @p a and @p b are identical
+ */
+static inline bool fr_limbs_equal(const fr_t *a, const fr_t *b) {
+    return ((a->l[0] ^ b->l[0]) | (a->l[1] ^ b->l[1]) | (a->l[2] ^ b->l[2]) | (a->l[3] ^ b->l[3])) == 0;
+}
+
 /**
  * Test whether the operand is zero in the finite field.
  *
  * @param p The field element to be checked
  * @retval true The element is zero
  * @retval false The element is non-zero
- *
- * @todo See if there is a more efficient way to check for zero in the finite field.
  */
 bool fr_is_zero(const fr_t *p) {
-    uint64_t a[4];
-    blst_uint64_from_fr(a, p);
-    return a[0] == 0 && a[1] == 0 && a[2] == 0 && a[3] == 0;
+    return fr_limbs_equal(p, &fr_zero);
 }
 
 /**
@@ -64,13 +82,9 @@ bool fr_is_zero(const fr_t *p) {
  * @param p The field element to be checked
  * @retval true The element is one
  * @retval false The element is not one
- *
- * @todo See if there is a more efficient way to check for one in the finite field.
  */
 bool fr_is_one(const fr_t *p) {
-    uint64_t a[4];
-    blst_uint64_from_fr(a, p);
-    return a[0] == 1 && a[1] == 0 && a[2] == 0 && a[3] == 0;
+    return fr_limbs_equal(p, &fr_one);
 }
 
 /**
@@ -81,9 +95,50 @@ bool fr_is_one(const fr_t *p) {
  * @retval false The element is not the NULL value
  */
 bool fr_is_null(const fr_t *p) {
-    uint64_t *null = (uint64_t *)&fr_null;
-    uint64_t *a = (uint64_t *)p;
-    return a[0] == null[0] && a[1] == null[1] && a[2] == null[2] && a[3] == null[3];
+    return fr_limbs_equal(p, &fr_null);
+}
+
+/**
+ * Find the positions of all elements of an array that are equal to a given value.
+ *
+ * @param[out] out Array of the indices of matching elements, in increasing order, length at least the return value
+ * @param[in]  a   Array of field elements, length @p len
+ * @param[in]  len The number of field elements
+ * @param[in]  v   The value to find
+ * @return The number of matching elements
+ */
+static uint64_t fr_find(uint64_t *out, const fr_t *a, uint64_t len, const fr_t *v) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < len; i++) {
+        // Always write, and only advance when there's a match, to avoid a hard-to-predict branch
+        out[count] = i;
+        count += fr_limbs_equal(&a[i], v);
+    }
+    return count;
+}
+
+/**
+ * Find the positions of all the zero elements of an array.
+ *
+ * @param[out] out Array of the indices of the zero elements, in increasing order, length @p len
+ * @param[in]  a   Array of field elements, length @p len
+ * @param[in]  len The number of field elements
+ * @return The number of zero elements
+ */
+uint64_t fr_find_zero(uint64_t *out, const fr_t *a, uint64_t len) {
+    return fr_find(out, a, len, &fr_zero);
+}
+
+/**
+ * Find the positions of all the NULL elements of an array.
+ *
+ * @param[out] out Array of the indices of the NULL elements, in increasing order, length @p len
+ * @param[in]  a   Array of field elements, length @p len
+ * @param[in]  len The number of field elements
+ * @return The number of NULL elements
+ */
+uint64_t fr_find_null(uint64_t *out, const fr_t *a, uint64_t len) {
+    return fr_find(out, a, len, &fr_null);
 }
 
 /**
@@ -119,6 +174,37 @@ void fr_from_uint64(fr_t *out, uint64_t n) {
     fr_from_uint64s(out, vals);
 }
 
+/**
+ * Serialise a field element.
+ *
+ * @param[out] out The canonical value of @p a as 32 little-endian bytes
+ * @param[in]  a   The field element
+ */
+void fr_to_bytes(byte out[32], const fr_t *a) {
+    blst_scalar s;
+    blst_scalar_from_fr(&s, a);
+    for (int i = 0; i < 32; i++) {
+        out[i] = s.b[i];
+    }
+}
+
+/**
+ * Derive a field element from a message by hashing it.
+ *
+ * The SHA-256 hash of the message is truncated to 253 bits, which is always less than the field modulus. This is
+ * intended for Fiat-Shamir style challenges, where a small bias is not a concern.
+ *
+ * @param[out] out The field element
+ * @param[in]  msg The message to be hashed
+ * @param[in]  len The length of @p msg in bytes
+ */
+void fr_from_hash(fr_t *out, const byte *msg, size_t len) {
+    blst_scalar s;
+    blst_sha256(s.b, msg, len);
+    s.b[31] &= 0x1f;
+    blst_fr_from_scalar(out, &s);
+}
+
 /**
  * Test whether two field elements are equal.
  *
@@ -128,10 +214,7 @@ void fr_from_uint64(fr_t *out, uint64_t n) {
  * @retval false otherwise
  */
 bool fr_equal(const fr_t *aa, const fr_t *bb) {
-    uint64_t a[4], b[4];
-    blst_uint64_from_fr(a, aa);
-    blst_uint64_from_fr(b, bb);
-    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
+    return fr_limbs_equal(aa, bb);
 }
 
 /**
@@ -187,6 +270,43 @@ void fr_inv(fr_t *out, const fr_t *a) {
     blst_fr_eucl_inverse(out, a);
 }
 
+/**
+ * Inverse of an array of field elements.
+ *
+ * Uses Montgomery's trick to get away with a single inversion and `3(len - 1)` multiplications. Zero has no inverse,
+ * so zero entries are skipped and result in zero outputs, as #fr_inv would give.
+ *
+ * @remark The running products are kept in @p out, so @p out and @p a must not overlap.
+ *
+ * @param[out] out Array of the inverses of the elements of @p a, length @p len
+ * @param[in]  a   Array of field elements, length @p len
+ * @param[in]  len The number of field elements
+ */
+void fr_batch_inv(fr_t *out, const fr_t *a, uint64_t len) {
+    fr_t acc = fr_one, inv;
+
+    // out[i] is the product of all the non-zero a[j] for j < i
+    for (uint64_t i = 0; i < len; i++) {
+        out[i] = acc;
+        if (!fr_is_zero(&a[i])) {
+            blst_fr_mul(&acc, &acc, &a[i]);
+        }
+    }
+
+    blst_fr_eucl_inverse(&acc, &acc);
+
+    // Now acc is the inverse of the product of all the non-zero a[j] for j <= i
+    for (uint64_t i = len; i > 0; i--) {
+        if (fr_is_zero(&a[i - 1])) {
+            out[i - 1] = fr_zero;
+        } else {
+            blst_fr_mul(&inv, &acc, &out[i - 1]);
+            blst_fr_mul(&acc, &acc, &a[i - 1]);
+            out[i - 1] = inv;
+        }
+    }
+}
+
 /**
  * Division of two field elements.
  *
@@ -234,6 +354,403 @@ void fr_pow(fr_t *out, const fr_t *a, uint64_t n) {
     }
 }
 
+#ifdef __AVX512IFMA__
+
+/*
+ * AVX-512 IFMA kernels.
+ *
+ * Eight field elements are processed at once, with limb `j` of all eight held in one vector register. The elements are
+ * converted from blst's four 64-bit limbs to five 52-bit limbs, which is what the IFMA multiply-add instructions
+ * operate on, and back again afterwards. The values stay in Montgomery form throughout.
+ */
+
+/** Mask for a 52-bit limb. */
+#define IFMA_MASK 0xfffffffffffffL
+
+/** The field modulus `r` in 52-bit limbs. */
+static const uint64_t ifma_r[5] = {0xfffff00000001L, 0x2fffe5bfefffL, 0x9a1d80553bda4L, 0x7d483339d8080L,
+                                   0x73eda753299dL};
+
+/** `-1 / r` modulo `2^52`, for Montgomery reduction. */
+#define IFMA_R_INV 0xffffeffffffffL
+
+/**
+ * Load eight consecutive or strided field elements as four vectors of 64-bit limbs.
+ *
+ * @param[out] l      Limb `j` of each of the elements, in `l[j]`
+ * @param[in]  p      The first element
+ * @param[in]  stride The distance between the elements, which may be zero
+ */
+static inline void ifma_load(__m512i l[4], const fr_t *p, uint64_t stride) {
+    if (stride == 1) {
+        // Transpose the 8 x 4 matrix of limbs
+        const __m512i lo = _mm512_setr_epi64(0, 4, 8, 12, 1, 5, 9, 13);
+        const __m512i hi = _mm512_setr_epi64(2, 6, 10, 14, 3, 7, 11, 15);
+        const __m512i first = _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 10, 11);
+        const __m512i second = _mm512_setr_epi64(4, 5, 6, 7, 12, 13, 14, 15);
+        __m512i z0 = _mm512_loadu_si512(p), z1 = _mm512_loadu_si512(p + 2);
+        __m512i z2 = _mm512_loadu_si512(p + 4), z3 = _mm512_loadu_si512(p + 6);
+        __m512i t0 = _mm512_permutex2var_epi64(z0, lo, z1), t1 = _mm512_permutex2var_epi64(z0, hi, z1);
+        __m512i u0 = _mm512_permutex2var_epi64(z2, lo, z3), u1 = _mm512_permutex2var_epi64(z2, hi, z3);
+        l[0] = _mm512_permutex2var_epi64(t0, first, u0);
+        l[1] = _mm512_permutex2var_epi64(t0, second, u0);
+        l[2] = _mm512_permutex2var_epi64(t1, first, u1);
+        l[3] = _mm512_permutex2var_epi64(t1, second, u1);
+    } else {
+        long long s = 4 * (long long)stride;
+        __m512i idx = _mm512_setr_epi64(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+#pragma GCC unroll 4
+        for (int j = 0; j < 4; j++) {
+            l[j] = _mm512_i64gather_epi64(idx, (const long long *)p->l + j, 8);
+        }
+    }
+}
+
+/**
+ * Store four vectors of 64-bit limbs as eight consecutive field elements.
+ *
+ * @param[out] p The first element
+ * @param[in]  l Limb `j` of each of the elements, in `l[j]`
+ */
+static inline void ifma_store(fr_t *p, const __m512i l[4]) {
+    const __m512i lo = _mm512_setr_epi64(0, 4, 8, 12, 1, 5, 9, 13);
+    const __m512i hi = _mm512_setr_epi64(2, 6, 10, 14, 3, 7, 11, 15);
+    const __m512i first = _mm512_setr_epi64(0, 1, 2, 3, 8, 9, 10, 11);
+    const __m512i second = _mm512_setr_epi64(4, 5, 6, 7, 12, 13, 14, 15);
+    __m512i t0 = _mm512_permutex2var_epi64(l[0], first, l[1]), u0 = _mm512_permutex2var_epi64(l[0], second, l[1]);
+    __m512i t1 = _mm512_permutex2var_epi64(l[2], first, l[3]), u1 = _mm512_permutex2var_epi64(l[2], second, l[3]);
+    _mm512_storeu_si512(p, _mm512_permutex2var_epi64(t0, lo, t1));
+    _mm512_storeu_si512(p + 2, _mm512_permutex2var_epi64(t0, hi, t1));
+    _mm512_storeu_si512(p + 4, _mm512_permutex2var_epi64(u0, lo, u1));
+    _mm512_storeu_si512(p + 6, _mm512_permutex2var_epi64(u0, hi, u1));
+}
+
+/**
+ * Convert from 64-bit limbs to 52-bit limbs.
+ *
+ * @param[out] x     The value in 52-bit limbs
+ * @param[in]  l     The value in 64-bit limbs
+ * @param[in]  times16 Whether to multiply the value by 16 while converting, see ifma_mont_mul()
+ */
+static inline void ifma_from_64(__m512i x[5], const __m512i l[4], bool times16) {
+    const __m512i mask = _mm512_set1_epi64(IFMA_MASK);
+    int s = times16 ? 4 : 0;
+    x[0] = _mm512_and_si512(_mm512_slli_epi64(l[0], s), mask);
+    x[1] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(l[0], 52 - s), _mm512_slli_epi64(l[1], 12 + s)), mask);
+    x[2] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(l[1], 40 - s), _mm512_slli_epi64(l[2], 24 + s)), mask);
+    x[3] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(l[2], 28 - s), _mm512_slli_epi64(l[3], 36 + s)), mask);
+    x[4] = _mm512_srli_epi64(l[3], 16 - s);
+}
+
+/**
+ * Convert from normalised 52-bit limbs to 64-bit limbs.
+ *
+ * @param[out] l The value in 64-bit limbs
+ * @param[in]  x The value in 52-bit limbs, less than `2^256`
+ */
+static inline void ifma_to_64(__m512i l[4], const __m512i x[5]) {
+    l[0] = _mm512_or_si512(x[0], _mm512_slli_epi64(x[1], 52));
+    l[1] = _mm512_or_si512(_mm512_srli_epi64(x[1], 12), _mm512_slli_epi64(x[2], 40));
+    l[2] = _mm512_or_si512(_mm512_srli_epi64(x[2], 24), _mm512_slli_epi64(x[3], 28));
+    l[3] = _mm512_or_si512(_mm512_srli_epi64(x[3], 36), _mm512_slli_epi64(x[4], 16));
+}
+
+/**
+ * Propagate carries and borrows so that each limb but the top one is in `[0, 2^52)`.
+ *
+ * @param[in,out] x The value, with signed limbs
+ */
+static inline void ifma_carry(__m512i x[5]) {
+    const __m512i mask = _mm512_set1_epi64(IFMA_MASK);
+#pragma GCC unroll 4
+    for (int j = 0; j < 4; j++) {
+        x[j + 1] = _mm512_add_epi64(x[j + 1], _mm512_srai_epi64(x[j], 52));
+        x[j] = _mm512_and_si512(x[j], mask);
+    }
+}
+
+/**
+ * Reduce a normalised value in `[0, 2r)` to `[0, r)`.
+ *
+ * @param[in,out] x The value
+ */
+static inline void ifma_reduce_once(__m512i x[5]) {
+    __m512i d[5];
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        d[j] = _mm512_sub_epi64(x[j], _mm512_set1_epi64(ifma_r[j]));
+    }
+    ifma_carry(d);
+    __mmask8 keep = _mm512_cmplt_epi64_mask(d[4], _mm512_setzero_si512());
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        x[j] = _mm512_mask_blend_epi64(keep, d[j], x[j]);
+    }
+}
+
+/**
+ * Montgomery multiplication in 52-bit limbs.
+ *
+ * The Montgomery radix here is `2^260` rather than blst's `2^256`. Passing `16 * a` for @p a makes up the difference,
+ * so that the result is in blst's Montgomery form. This is free, see ifma_from_64().
+ *
+ * @param[out] out @p a times @p b, reduced and normalised
+ * @param[in]  a   The first value, less than `16 * r`, in normalised 52-bit limbs
+ * @param[in]  b   The second value, less than `r`, in normalised 52-bit limbs
+ */
+static inline void ifma_mont_mul(__m512i out[5], const __m512i a[5], const __m512i b[5]) {
+    const __m512i zero = _mm512_setzero_si512(), r_inv = _mm512_set1_epi64(IFMA_R_INV);
+    __m512i r[5], t[6];
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        r[j] = _mm512_set1_epi64(ifma_r[j]);
+        t[j] = zero;
+    }
+    t[5] = zero;
+
+    // Fully unrolled, so that the limbs stay in registers
+#pragma GCC unroll 5
+    for (int i = 0; i < 5; i++) {
+#pragma GCC unroll 5
+        for (int j = 0; j < 5; j++) {
+            t[j] = _mm512_madd52lo_epu64(t[j], a[j], b[i]);
+            t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], a[j], b[i]);
+        }
+        __m512i m = _mm512_madd52lo_epu64(zero, t[0], r_inv);
+#pragma GCC unroll 5
+        for (int j = 0; j < 5; j++) {
+            t[j] = _mm512_madd52lo_epu64(t[j], m, r[j]);
+            t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], m, r[j]);
+        }
+        // The bottom limb is now divisible by 2^52
+        t[1] = _mm512_add_epi64(t[1], _mm512_srli_epi64(t[0], 52));
+#pragma GCC unroll 5
+        for (int j = 0; j < 5; j++) {
+            t[j] = t[j + 1];
+        }
+        t[5] = zero;
+    }
+
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        out[j] = t[j];
+    }
+    ifma_carry(out);
+    ifma_reduce_once(out);
+}
+
+/**
+ * Modular addition in 52-bit limbs.
+ *
+ * @param[out] out @p a plus @p b
+ * @param[in]  a   The first value, less than `r`
+ * @param[in]  b   The second value, less than `r`
+ */
+static inline void ifma_add(__m512i out[5], const __m512i a[5], const __m512i b[5]) {
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        out[j] = _mm512_add_epi64(a[j], b[j]);
+    }
+    ifma_carry(out);
+    ifma_reduce_once(out);
+}
+
+/**
+ * Modular subtraction in 52-bit limbs.
+ *
+ * @param[out] out @p a minus @p b
+ * @param[in]  a   The first value, less than `r`
+ * @param[in]  b   The second value, less than `r`
+ */
+static inline void ifma_sub(__m512i out[5], const __m512i a[5], const __m512i b[5]) {
+    __m512i d[5];
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        out[j] = _mm512_sub_epi64(a[j], b[j]);
+    }
+    ifma_carry(out);
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        d[j] = _mm512_add_epi64(out[j], _mm512_set1_epi64(ifma_r[j]));
+    }
+    ifma_carry(d);
+    __mmask8 negative = _mm512_cmplt_epi64_mask(out[4], _mm512_setzero_si512());
+#pragma GCC unroll 5
+    for (int j = 0; j < 5; j++) {
+        out[j] = _mm512_mask_blend_epi64(negative, out[j], d[j]);
+    }
+}
+
+/** The number of field elements processed together by the IFMA kernels. */
+#define FR_VEC_WIDTH 8
+
+#endif // __AVX512IFMA__
+
+/**
+ * Add arrays of field elements.
+ *
+ * @param[out] out `a[i] + b[i]` (array of length @p n), which may be the same as @p a or @p b
+ * @param[in]  a   Field elements (array of length @p n)
+ * @param[in]  b   Field elements (array of length @p n)
+ * @param[in]  n   The number of elements
+ */
+void fr_vec_add(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        blst_fr_add(&out[i], &a[i], &b[i]);
+    }
+}
+
+/**
+ * Subtract arrays of field elements.
+ *
+ * @param[out] out `a[i] - b[i]` (array of length @p n), which may be the same as @p a or @p b
+ * @param[in]  a   Field elements (array of length @p n)
+ * @param[in]  b   Field elements (array of length @p n)
+ * @param[in]  n   The number of elements
+ */
+void fr_vec_sub(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+        blst_fr_sub(&out[i], &a[i], &b[i]);
+    }
+}
+
+/**
+ * Multiply arrays of field elements, with a stride through the second array.
+ *
+ * @param[out] out      `a[i] * b[i * b_stride]` (array of length @p n), which may be the same as @p a
+ * @param[in]  a        Field elements (array of length @p n)
+ * @param[in]  b        Field elements (array of length `n * b_stride`)
+ * @param[in]  b_stride The stride through @p b, which may be zero
+ * @param[in]  n        The number of elements
+ */
+static void fr_vec_mul_strided(fr_t *out, const fr_t *a, const fr_t *b, uint64_t b_stride, uint64_t n) {
+    uint64_t i = 0;
+#ifdef __AVX512IFMA__
+    for (; i + FR_VEC_WIDTH <= n; i += FR_VEC_WIDTH) {
+        __m512i l[4], x[5], y[5];
+        ifma_load(l, &b[i * b_stride], b_stride);
+        ifma_from_64(x, l, true);
+        ifma_load(l, &a[i], 1);
+        ifma_from_64(y, l, false);
+        ifma_mont_mul(x, x, y);
+        ifma_to_64(l, x);
+        ifma_store(&out[i], l);
+    }
+#endif
+    for (; i < n; i++) {
+        blst_fr_mul(&out[i], &a[i], &b[i * b_stride]);
+    }
+}
+
+/**
+ * Multiply arrays of field elements.
+ *
+ * @remark Uses AVX-512 IFMA instructions when compiled for them, for example with `-march=native` on a CPU that has
+ * them.
+ *
+ * @param[out] out `a[i] * b[i]` (array of length @p n), which may be the same as @p a or @p b
+ * @param[in]  a   Field elements (array of length @p n)
+ * @param[in]  b   Field elements (array of length @p n)
+ * @param[in]  n   The number of elements
+ */
+void fr_vec_mul(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n) {
+    fr_vec_mul_strided(out, a, b, 1, n);
+}
+
+/**
+ * Multiply an array of field elements by a single field element.
+ *
+ * @param[out] out `a[i] * s` (array of length @p n), which may be the same as @p a
+ * @param[in]  a   Field elements (array of length @p n)
+ * @param[in]  s   A field element
+ * @param[in]  n   The number of elements
+ */
+void fr_vec_scale(fr_t *out, const fr_t *a, const fr_t *s, uint64_t n) {
+    fr_vec_mul_strided(out, a, s, 0, n);
+}
+
+/**
+ * Decimation-in-time butterflies on arrays of field elements.
+ *
+ * Replaces `(a[i], b[i])` with `(a[i] + t, a[i] - t)`, where `t = b[i] * w[i * w_stride]`.
+ *
+ * @remark Uses AVX-512 IFMA instructions when compiled for them.
+ *
+ * @param[in,out] a        Field elements (array of length @p n)
+ * @param[in,out] b        Field elements (array of length @p n), not overlapping @p a
+ * @param[in]     w        The twiddle factors (array of length `n * w_stride`)
+ * @param[in]     w_stride The stride through @p w, which may be zero
+ * @param[in]     n        The number of butterflies
+ */
+void fr_vec_butterfly(fr_t *a, fr_t *b, const fr_t *w, uint64_t w_stride, uint64_t n) {
+    uint64_t i = 0;
+#ifdef __AVX512IFMA__
+    for (; i + FR_VEC_WIDTH <= n; i += FR_VEC_WIDTH) {
+        __m512i l[4], x[5], y[5], t[5];
+        ifma_load(l, &w[i * w_stride], w_stride);
+        ifma_from_64(t, l, true);
+        ifma_load(l, &b[i], 1);
+        ifma_from_64(y, l, false);
+        ifma_mont_mul(t, t, y);
+        ifma_load(l, &a[i], 1);
+        ifma_from_64(x, l, false);
+        ifma_add(y, x, t);
+        ifma_to_64(l, y);
+        ifma_store(&a[i], l);
+        ifma_sub(y, x, t);
+        ifma_to_64(l, y);
+        ifma_store(&b[i], l);
+    }
+#endif
+    for (; i < n; i++) {
+        fr_t t;
+        blst_fr_mul(&t, &b[i], &w[i * w_stride]);
+        blst_fr_sub(&b[i], &a[i], &t);
+        blst_fr_add(&a[i], &a[i], &t);
+    }
+}
+
+/**
+ * Decimation-in-frequency butterflies on arrays of field elements.
+ *
+ * Replaces `(a[i], b[i])` with `(a[i] + b[i], (a[i] - b[i]) * w[i * w_stride])`.
+ *
+ * @remark Uses AVX-512 IFMA instructions when compiled for them.
+ *
+ * @param[in,out] a        Field elements (array of length @p n)
+ * @param[in,out] b        Field elements (array of length @p n), not overlapping @p a
+ * @param[in]     w        The twiddle factors (array of length `n * w_stride`)
+ * @param[in]     w_stride The stride through @p w, which may be zero
+ * @param[in]     n        The number of butterflies
+ */
+void fr_vec_butterfly_dif(fr_t *a, fr_t *b, const fr_t *w, uint64_t w_stride, uint64_t n) {
+    uint64_t i = 0;
+#ifdef __AVX512IFMA__
+    for (; i + FR_VEC_WIDTH <= n; i += FR_VEC_WIDTH) {
+        __m512i l[4], x[5], y[5], t[5];
+        ifma_load(l, &a[i], 1);
+        ifma_from_64(x, l, false);
+        ifma_load(l, &b[i], 1);
+        ifma_from_64(y, l, false);
+        ifma_add(t, x, y);
+        ifma_to_64(l, t);
+        ifma_store(&a[i], l);
+        ifma_sub(t, x, y);
+        ifma_load(l, &w[i * w_stride], w_stride);
+        ifma_from_64(x, l, true);
+        ifma_mont_mul(t, x, t);
+        ifma_to_64(l, t);
+        ifma_store(&b[i], l);
+    }
+#endif
+    for (; i < n; i++) {
+        fr_t t;
+        blst_fr_sub(&t, &a[i], &b[i]);
+        blst_fr_add(&a[i], &a[i], &b[i]);
+        blst_fr_mul(&b[i], &t, &w[i * w_stride]);
+    }
+}
+
 /**
  * Test G1 point for being infinity/the identity.
  *
@@ -280,30 +797,189 @@ bool g1_equal(const g1_t *a, const g1_t *b) {
     return blst_p1_is_equal(a, b);
 }
 
+/** Window width of the wNAF recoding in g1_mul(). */
+#define G1_MUL_WNAF_BITS 5
+
+/** Number of precomputed odd multiples, `P, 3P, ..., (2^(w-1) - 1)P`, for each half of the GLV split. */
+#define G1_MUL_TABLE_SIZE (1 << (G1_MUL_WNAF_BITS - 2))
+
+/**
+ * The GLV eigenvalue `lambda = z^2 - 1`, where `z` is the BLS parameter, as two 64-bit limbs.
+ *
+ * The endomorphism `phi(x, y) = (beta x, y)` acts on G1 as multiplication by `lambda`, and `r = lambda^2 + lambda + 1`.
+ */
+static const uint64_t glv_lambda[2] = {0x00000000ffffffffL, 0xac45a4010001a402L};
+
+/** The cube root of unity in Fp that goes with #glv_lambda, in Montgomery form. */
+static const blst_fp glv_beta = {{0xcd03c9e48671f071L, 0x5dab22461fcda5d2L, 0x587042afd3851b95L, 0x8eb60ebe01bacb9eL,
+                                  0x03f97d6e83d050d2L, 0x18f0206554638741L}};
+
+/**
+ * Split a scalar for the GLV method.
+ *
+ * Finds `k1` and `k2`, both less than `2^128`, such that `k = k1 + k2 * lambda`. Since `r = lambda^2 + lambda + 1`
+ * this is simply the quotient and remainder of `k` divided by `lambda`.
+ *
+ * @param[out] k1 The low half, `k mod lambda`
+ * @param[out] k2 The high half, `k / lambda`
+ * @param[in]  k  The scalar as four 64-bit limbs, least significant first, less than the group order
+ */
+static void glv_split(unsigned __int128 *k1, unsigned __int128 *k2, const uint64_t k[4]) {
+    unsigned __int128 lambda = ((unsigned __int128)glv_lambda[1] << 64) | glv_lambda[0];
+    unsigned __int128 rem = 0, quo = 0;
+    for (int i = 255; i >= 0; i--) {
+        // The remainder is less than lambda, but shifting it can overflow 128 bits
+        bool carry = rem >> 127;
+        rem = (rem << 1) | ((k[i / 64] >> (i % 64)) & 1);
+        quo <<= 1;
+        if (carry || rem >= lambda) {
+            rem -= lambda;
+            quo |= 1;
+        }
+    }
+    *k1 = rem;
+    *k2 = quo;
+}
+
+/**
+ * Recode a scalar in width-w non-adjacent form.
+ *
+ * Each non-zero digit is odd and less than `2^(w-1)` in absolute value, and is followed by at least `w - 1` zeros.
+ *
+ * @param[out] digits The digits, least significant first. Must have room for #G1_MUL_MAX_DIGITS entries
+ * @param[in]  k      The scalar to recode, less than `2^128 - 2^(w-1)`
+ * @return The number of digits written
+ */
+static int wnaf_recode(int8_t *digits, unsigned __int128 k) {
+    int len = 0;
+    while (k) {
+        int d = 0;
+        if (k & 1) {
+            d = (int)(k & ((1 << G1_MUL_WNAF_BITS) - 1));
+            if (d >= 1 << (G1_MUL_WNAF_BITS - 1)) d -= 1 << G1_MUL_WNAF_BITS;
+            if (d > 0) {
+                k -= d;
+            } else {
+                k += -d;
+            }
+        }
+        digits[len++] = d;
+        k >>= 1;
+    }
+    return len;
+}
+
+/**
+ * Add a signed multiple of a point from a table of odd multiples.
+ *
+ * @param[in,out] acc   The accumulator
+ * @param[in]     table The odd multiples `P, 3P, 5P, ...`
+ * @param[in]     d     An odd wNAF digit
+ */
+static void g1_add_wnaf_digit(g1_t *acc, const g1_t *table, int d) {
+    if (d > 0) {
+        blst_p1_add_or_double(acc, acc, &table[d >> 1]);
+    } else {
+        g1_t tmp = table[-d >> 1];
+        blst_p1_cneg(&tmp, true);
+        blst_p1_add_or_double(acc, acc, &tmp);
+    }
+}
+
+/**
+ * Recode a field element for multiplying G1 group elements.
+ *
+ * Does the scalar work of #g1_mul: the GLV split and the wNAF recoding of both halves. A scalar that multiplies many
+ * points, such as an FFT twiddle factor, can be recoded once and used with #g1_mul_recoded.
+ *
+ * @param[out] out The recoded scalar
+ * @param[in]  b   The multiplier
+ */
+void g1_mul_recode(g1_mul_recoding_t *out, const fr_t *b) {
+    uint64_t k[4];
+    unsigned __int128 k1, k2;
+
+    blst_uint64_from_fr(k, b);
+    glv_split(&k1, &k2, k);
+    out->len1 = wnaf_recode(out->d1, k1);
+    out->len2 = wnaf_recode(out->d2, k2);
+}
+
+/**
+ * Multiply a G1 group element by a recoded field element.
+ *
+ * The two halves of the GLV split share a single run of doublings, and small scalars skip the leading zero digits
+ * entirely. Multiplication by zero or one costs nothing. None of this is constant time, so it must not be used with
+ * secret scalars.
+ *
+ * @param[out] out [@p b]@p a
+ * @param[in]  a   The G1 group element
+ * @param[in]  b   The multiplier, recoded by #g1_mul_recode
+ */
+void g1_mul_recoded(g1_t *out, const g1_t *a, const g1_mul_recoding_t *b) {
+    const int8_t *d1 = b->d1, *d2 = b->d2;
+    int len1 = b->len1, len2 = b->len2;
+    g1_t t1[G1_MUL_TABLE_SIZE], t2[G1_MUL_TABLE_SIZE], dbl, acc = g1_identity;
+
+    if (len1 == 0 && len2 == 0) {
+        *out = g1_identity;
+        return;
+    }
+    if (len1 == 1 && len2 == 0 && d1[0] == 1) {
+        *out = *a;
+        return;
+    }
+
+    // Odd multiples of a, and their images under the endomorphism when the high half is needed
+    t1[0] = *a;
+    blst_p1_double(&dbl, a);
+    for (int i = 1; i < G1_MUL_TABLE_SIZE; i++) {
+        blst_p1_add_or_double(&t1[i], &t1[i - 1], &dbl);
+    }
+    if (len2) {
+        for (int i = 0; i < G1_MUL_TABLE_SIZE; i++) {
+            t2[i] = t1[i];
+            blst_fp_mul(&t2[i].x, &t2[i].x, &glv_beta);
+        }
+    }
+
+    for (int i = (len1 > len2 ? len1 : len2) - 1; i >= 0; i--) {
+        blst_p1_double(&acc, &acc);
+        if (i < len1 && d1[i]) g1_add_wnaf_digit(&acc, t1, d1[i]);
+        if (i < len2 && d2[i]) g1_add_wnaf_digit(&acc, t2, d2[i]);
+    }
+    *out = acc;
+}
+
 /**
  * Multiply a G1 group element by a field element.
  *
  * This "undoes" the Blst constant-timedness. FFTs do a lot of multiplication by one, so constant time is rather slow.
  *
+ * The scalar is split in two halves of at most 128 bits using the GLV endomorphism, and each half is recoded in wNAF
+ * form, as by #g1_mul_recode. See #g1_mul_recoded for the multiplication itself. None of this is constant time, so it
+ * must not be used with secret scalars.
+ *
  * @param[out] out [@p b]@p a
  * @param[in]  a   The G1 group element
  * @param[in]  b   The multiplier
  */
 void g1_mul(g1_t *out, const g1_t *a, const fr_t *b) {
-    blst_scalar s;
-    blst_scalar_from_fr(&s, b);
+    uint64_t k[4];
+    g1_mul_recoding_t r;
 
-    // Count the number of bytes to be multiplied.
-    int i = sizeof(blst_scalar);
-    while (i && !s.b[i - 1]) --i;
-    if (i == 0) {
+    blst_uint64_from_fr(k, b);
+    if (!(k[0] | k[1] | k[2] | k[3])) {
         *out = g1_identity;
-    } else if (i == 1 && s.b[0] == 1) {
+        return;
+    }
+    if (k[0] == 1 && !(k[1] | k[2] | k[3])) {
         *out = *a;
-    } else {
-        // Count the number of bits to be multiplied.
-        blst_p1_mult(out, a, s.b, 8 * i - 7 + log_2_byte(s.b[i - 1]));
+        return;
     }
+
+    g1_mul_recode(&r, b);
+    g1_mul_recoded(out, a, &r);
 }
 
 /**
@@ -319,6 +995,166 @@ void g1_sub(g1_t *out, const g1_t *a, const g1_t *b) {
     blst_p1_add_or_double(out, a, &bneg);
 }
 
+/**
+ * Serialise a G1 group element in compressed form.
+ *
+ * @param[out] out The compressed point, 48 bytes
+ * @param[in]  a   The G1 group element
+ */
+void g1_to_bytes(byte out[48], const g1_t *a) {
+    blst_p1_compress(out, a);
+}
+
+/**
+ * Convert an array of G1 group elements to affine coordinates.
+ *
+ * Uses Montgomery's trick, so that there is only one field inversion for each run of non-infinite points.
+ *
+ * @param[out] out Array of affine G1 group elements, length @p len
+ * @param[in]  in  Array of G1 group elements, length @p len
+ * @param[in]  len The number of group elements
+ */
+void g1_to_affine(g1_affine_t *out, const g1_t *in, uint64_t len) {
+    uint64_t start = 0;
+    // Batch normalisation can't cope with points at infinity, so we convert the runs in between them separately
+    for (uint64_t i = 0; i <= len; i++) {
+        if (i == len || blst_p1_is_inf(&in[i])) {
+            if (i > start) {
+                const g1_t *run[2] = {&in[start], NULL}; // A NULL second pointer means a contiguous array
+                blst_p1s_to_affine(&out[start], run, i - start);
+            }
+            if (i < len) {
+                out[i] = g1_affine_identity;
+            }
+            start = i + 1;
+        }
+    }
+}
+
+/**
+ * Convert a G1 group element from affine coordinates.
+ *
+ * @param[out] out The G1 group element
+ * @param[in]  in  The G1 group element in affine coordinates
+ */
+void g1_from_affine(g1_t *out, const g1_affine_t *in) {
+    blst_p1_from_affine(out, in);
+}
+
+/**
+ * Add or double G1 points, where the second is in affine coordinates.
+ *
+ * This "mixed" addition is cheaper than a full addition of two projective points.
+ *
+ * @param[out] out Sum of the inputs
+ * @param[in]  a   A G1 group point
+ * @param[in]  b   A G1 group point in affine coordinates
+ */
+void g1_add_affine(g1_t *out, const g1_t *a, const g1_affine_t *b) {
+    blst_p1_add_or_double_affine(out, a, b);
+}
+
+/** One in Blst's `blst_fp` Montgomery representation. */
+static const fp_t fp_one = {{0x760900000002fffdL, 0xebf4000bc40c0002L, 0x5f48985753c758baL, 0x77ce585370525745L,
+                             0x5c071a97a256ec6dL, 0x15f65ec3fa80e493L}};
+
+/**
+ * Whether an affine butterfly needs the projective fallback.
+ *
+ * The affine formulas can't cope with points at infinity, nor with equal x-coordinates, where the sum or difference
+ * is a doubling or the identity.
+ */
+static bool g1_affine_butterfly_is_special(const g1_affine_t *a, const g1_affine_t *b) {
+    return blst_p1_affine_is_inf(a) || blst_p1_affine_is_inf(b) || !memcmp(&a->x, &b->x, sizeof a->x);
+}
+
+/**
+ * One pass of FFT butterflies on affine G1 points.
+ *
+ * Replaces each pair `(x[j + k], x[j + k + h])` with their sum and difference, for each block of `2 * h` points
+ * starting at `j` and each `k` less than @p h. Any twiddle factors must already have been applied to the second
+ * point of each pair.
+ *
+ * In affine coordinates the sum and the difference share the denominator `x_b - x_a` of their slopes, and
+ * Montgomery's trick shares a single field inversion across the whole pass. Each butterfly then costs about nine
+ * field multiplications, against about twenty for two projective additions. The rare pairs involving the identity or
+ * equal x-coordinates are done in projective coordinates instead.
+ *
+ * If the working space can't be allocated, all the butterflies are done in projective coordinates.
+ *
+ * @param[in,out] x The affine G1 points, length @p n
+ * @param[in]     n The number of points, a multiple of `2 * h`
+ * @param[in]     h The distance between the points of each pair, a power of two
+ */
+void g1_affine_butterfly_pass(g1_affine_t *x, uint64_t n, uint64_t h) {
+    uint64_t len = n / 2;
+    fp_t *prod = len ? malloc(len * sizeof *prod) : NULL;
+    fp_t acc = fp_one, inv, d, lambda, t;
+
+    // Running products of the denominators
+    for (uint64_t i = 0; prod != NULL && i < len; i++) {
+        uint64_t k = i & (h - 1), j = (i - k) * 2;
+        const g1_affine_t *a = &x[j + k], *b = &x[j + k + h];
+        if (!g1_affine_butterfly_is_special(a, b)) {
+            blst_fp_sub(&d, &b->x, &a->x);
+            blst_fp_mul(&acc, &acc, &d);
+        }
+        prod[i] = acc;
+    }
+    if (prod != NULL) blst_fp_eucl_inverse(&inv, &acc);
+
+    // Work backwards, peeling off one inverse at a time
+    for (uint64_t i = len; i-- > 0;) {
+        uint64_t k = i & (h - 1), j = (i - k) * 2;
+        g1_affine_t *a = &x[j + k], *b = &x[j + k + h], sum, diff;
+
+        if (prod == NULL || g1_affine_butterfly_is_special(a, b)) {
+            g1_t pa, pb, ps;
+            g1_from_affine(&pa, a);
+            g1_from_affine(&pb, b);
+            blst_p1_add_or_double(&ps, &pa, &pb);
+            blst_p1_to_affine(&sum, &ps);
+            blst_p1_cneg(&pb, true);
+            blst_p1_add_or_double(&ps, &pa, &pb);
+            blst_p1_to_affine(&diff, &ps);
+        } else {
+            // inv is currently the inverse of prod[i], so this gives 1 / (x_b - x_a)
+            if (i > 0) {
+                blst_fp_mul(&t, &inv, &prod[i - 1]);
+            } else {
+                t = inv;
+            }
+            blst_fp_sub(&d, &b->x, &a->x);
+            blst_fp_mul(&inv, &inv, &d);
+
+            // a + b: lambda = (y_b - y_a) / (x_b - x_a)
+            blst_fp_sub(&lambda, &b->y, &a->y);
+            blst_fp_mul(&lambda, &lambda, &t);
+            blst_fp_sqr(&sum.x, &lambda);
+            blst_fp_sub(&sum.x, &sum.x, &a->x);
+            blst_fp_sub(&sum.x, &sum.x, &b->x);
+            blst_fp_sub(&sum.y, &a->x, &sum.x);
+            blst_fp_mul(&sum.y, &sum.y, &lambda);
+            blst_fp_sub(&sum.y, &sum.y, &a->y);
+
+            // a - b: lambda = (-y_b - y_a) / (x_b - x_a)
+            blst_fp_add(&lambda, &b->y, &a->y);
+            blst_fp_cneg(&lambda, &lambda, true);
+            blst_fp_mul(&lambda, &lambda, &t);
+            blst_fp_sqr(&diff.x, &lambda);
+            blst_fp_sub(&diff.x, &diff.x, &a->x);
+            blst_fp_sub(&diff.x, &diff.x, &b->x);
+            blst_fp_sub(&diff.y, &a->x, &diff.x);
+            blst_fp_mul(&diff.y, &diff.y, &lambda);
+            blst_fp_sub(&diff.y, &diff.y, &a->y);
+        }
+        *a = sum;
+        *b = diff;
+    }
+
+    free(prod);
+}
+
 /**
  * Test G2 points for equality.
  *
@@ -368,20 +1204,37 @@ void g2_dbl(g2_t *out, const g2_t *a) {
 }
 
 /**
- * Calculate a linear combination of G1 group elements.
+ * Prepare a G2 point for repeated use in pairings.
  *
- * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
+ * Precomputes the line functions of the Miller loop, which depend only on the G2 point. This is worthwhile for points
+ * that are used in many pairings, such as those from the trusted setup.
+ *
+ * @param[out] out The prepared point, for use with #pairings_verify_prepared
+ * @param[in]  a   The G2 group point
+ */
+void g2_prepare(g2_prepared_t *out, const g2_t *a) {
+    blst_p2_affine aa;
+    out->is_inf = blst_p2_is_inf(a);
+    if (!out->is_inf) {
+        blst_p2_to_affine(&aa, a);
+        blst_precompute_lines(out->lines, &aa);
+    }
+}
+
+/**
+ * Calculate a linear combination of G1 group elements, the slow way.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`, using one scalar
+ * multiplication per point.
+ *
+ * This is simple, and ok for tiny sizes. It's mostly useful for testing.
  *
  * @param[out] out    The resulting sum-product
  * @param[in]  p      Array of G1 group elements, length @p len
  * @param[in]  coeffs Array of field elements, length @p len
  * @param[in]  len    The number of group/field elements
- *
- * @todo This could be substantially improved with an optimised multi-scalar multiplication. (1) Benchmark and see if
- * this is a bottleneck. (2) If so, look into optimised routines. [Notes from
- * Mamy](https://github.com/vacp2p/research/issues/7#issuecomment-690083000) on the topic.
  */
-void g1_linear_combination(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
+void g1_linear_combination_slow(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
     g1_t tmp;
     *out = g1_identity;
     for (uint64_t i = 0; i < len; i++) {
@@ -390,6 +1243,540 @@ void g1_linear_combination(g1_t *out, const g1_t *p, const fr_t *coeffs, const u
     }
 }
 
+/** Below this length #g1_linear_combination falls back to #g1_linear_combination_slow. Tunable parameter. */
+#define MSM_MIN_LEN 8
+
+/** How many tasks to aim for per thread when parallelising #g1_linear_combination_affine. Tunable parameter. */
+#define MSM_TASKS_PER_THREAD 4
+
+/** The largest Pippenger window size we will use, in bits. Keeps the bucket array a manageable size. */
+#define MSM_MAX_WINDOW_BITS 16
+
+/** Scalars are reduced modulo r, which is a 255 bit number. */
+#define MSM_SCALAR_BITS 255
+
+/**
+ * The number of signed-digit windows of @p c bits needed to cover a scalar.
+ *
+ * One more than the bare minimum, so that there is always room for the final carry of the signed-digit recoding.
+ *
+ * @param[in] c The window size in bits
+ * @return The number of windows
+ */
+static int msm_num_windows(int c) {
+    return MSM_SCALAR_BITS / c + 1;
+}
+
+/**
+ * Estimate the number of group additions in a Pippenger multi-scalar multiplication.
+ *
+ * Each window costs about `len` additions to fill the buckets and `2^c` additions to sum them (with signed digits
+ * there are `2^(c-1)` buckets, and summing each costs two additions).
+ *
+ * @param[in] len The number of points in the linear combination
+ * @param[in] c   The window size in bits
+ * @return The approximate number of group additions
+ */
+static uint64_t msm_cost(uint64_t len, int c) {
+    return msm_num_windows(c) * (len + ((uint64_t)1 << c));
+}
+
+/**
+ * Choose the Pippenger window size for a multi-scalar multiplication of length @p len.
+ *
+ * We pick the `c` that minimises #msm_cost.
+ *
+ * @param[in] len The number of points in the linear combination
+ * @return The window size in bits
+ */
+static int msm_window_bits(uint64_t len) {
+    int best_c = 1;
+    uint64_t best_cost = UINT64_MAX;
+    for (int c = 2; c <= MSM_MAX_WINDOW_BITS; c++) {
+        uint64_t cost = msm_cost(len, c);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_c = c;
+        }
+    }
+    return best_c;
+}
+
+/**
+ * Extract @p c bits from a scalar, starting at bit position @p pos.
+ *
+ * @param[in] s   The scalar, a little-endian sequence of bytes
+ * @param[in] pos The index of the lowest bit to extract. Bits beyond the end of the scalar read as zero.
+ * @param[in] c   The number of bits to extract, at most 16
+ * @return The extracted bits as an unsigned integer
+ */
+static uint32_t scalar_window(const blst_scalar *s, int pos, int c) {
+    int byte_pos = pos / 8;
+    uint32_t w = 0;
+    for (int k = 0; k < 3 && byte_pos + k < sizeof s->b; k++) {
+        w |= (uint32_t)s->b[byte_pos + k] << (8 * k);
+    }
+    return (w >> (pos % 8)) & (((uint32_t)1 << c) - 1);
+}
+
+/**
+ * Recode a scalar into signed digits for the Pippenger method.
+ *
+ * Each window of @p c bits becomes a digit in the range `[-2^(c-1), 2^(c-1)]`, borrowing from the next window when
+ * needed. This halves the number of buckets required, since a negative digit just adds the negated point.
+ *
+ * @param[out] digits      Array of @p num_windows digits, written at intervals of @p stride
+ * @param[in]  stride      The interval between consecutive digits in @p digits
+ * @param[in]  s           The scalar to be recoded
+ * @param[in]  c           The window size in bits
+ * @param[in]  num_windows The number of windows, see #msm_num_windows
+ */
+static void msm_signed_digits(int32_t *digits, uint64_t stride, const blst_scalar *s, int c, int num_windows) {
+    int32_t half = 1 << (c - 1), carry = 0;
+    for (int w = 0; w < num_windows; w++) {
+        int32_t d = (int32_t)scalar_window(s, w * c, c) + carry;
+        carry = d > half;
+        digits[w * stride] = d - (carry << c);
+    }
+}
+
+/**
+ * Sort points into buckets for the Pippenger method.
+ *
+ * Each point is added to the bucket indexed by the absolute value of its digit, negated if the digit is negative.
+ * Points with a zero digit are skipped. The points are affine so that we can use mixed addition, and negating them is
+ * just a matter of negating the y coordinate.
+ *
+ * @param[in,out] buckets The buckets, `buckets[j]` accumulates points with digit `j + 1` or `-(j + 1)`
+ * @param[in]     p       Array of affine G1 group elements, length @p len
+ * @param[in]     digits  Array of signed digits for the current window, length @p len
+ * @param[in]     len     The number of group elements
+ */
+static void msm_fill_buckets(g1_t *buckets, const g1_affine_t *p, const int32_t *digits, uint64_t len) {
+    for (uint64_t i = 0; i < len; i++) {
+        int32_t d = digits[i];
+        if (d > 0) {
+            blst_p1_add_or_double_affine(&buckets[d - 1], &buckets[d - 1], &p[i]);
+        } else if (d < 0) {
+            g1_affine_t neg = p[i];
+            blst_fp_cneg(&neg.y, &neg.y, !blst_p1_affine_is_inf(&neg));
+            blst_p1_add_or_double_affine(&buckets[-d - 1], &buckets[-d - 1], &neg);
+        }
+    }
+}
+
+/**
+ * Sum the buckets for the Pippenger method.
+ *
+ * Calculates `sum_j [j + 1]buckets_j` with a running sum, so that it costs only two additions per bucket.
+ *
+ * @param[out] out         The weighted sum of the buckets
+ * @param[in]  buckets     The buckets, as filled by #msm_fill_buckets
+ * @param[in]  num_buckets The number of buckets, `2^(c-1)` for window size `c`
+ */
+static void msm_sum_buckets(g1_t *out, const g1_t *buckets, uint64_t num_buckets) {
+    g1_t running = g1_identity;
+    *out = g1_identity;
+    for (uint64_t b = num_buckets; b > 0; b--) {
+        blst_p1_add_or_double(&running, &running, &buckets[b - 1]);
+        blst_p1_add_or_double(out, out, &running);
+    }
+}
+
+/**
+ * Empty the buckets for the Pippenger method.
+ *
+ * @param[out] buckets     The buckets
+ * @param[in]  num_buckets The number of buckets
+ */
+static void msm_clear_buckets(g1_t *buckets, uint64_t num_buckets) {
+    for (uint64_t b = 0; b < num_buckets; b++) {
+        buckets[b] = g1_identity;
+    }
+}
+
+/** The state shared between the threads of a linear combination. */
+typedef struct {
+    const g1_affine_t *p; /**< The points, or the fixed-base table */
+    uint64_t p_stride;    /**< The distance between the rows of a fixed-base table */
+    const fr_t *coeffs;   /**< The coefficients */
+    uint64_t len;         /**< The number of points and coefficients */
+    int c;                /**< The window size in bits */
+    int num_windows;      /**< The number of windows, see #msm_num_windows */
+    uint64_t num_buckets; /**< The number of buckets for each window */
+    uint64_t parts;       /**< The number of ranges the points are split into */
+    int num_threads;      /**< The number of threads, see #parallel_num_threads */
+    int32_t *digits;      /**< Window-major signed digits for the coefficients */
+    g1_t *buckets;        /**< Working space, `num_buckets` for each thread */
+    g1_t *sums;           /**< The partial result of each task */
+} msm_job;
+
+/**
+ * Allocate the working space for a linear combination.
+ *
+ * @param[in,out] job       The job, with all but the pointer members already set
+ * @param[in]     num_tasks The number of tasks the job is split into
+ * @return `true` if all is well, `false` if any allocation failed, in which case nothing remains allocated
+ */
+static bool msm_job_alloc(msm_job *job, uint64_t num_tasks) {
+    job->digits = malloc(job->num_windows * job->len * sizeof *job->digits);
+    job->buckets = malloc(job->num_threads * job->num_buckets * sizeof *job->buckets);
+    job->sums = malloc(num_tasks * sizeof *job->sums);
+    if (job->digits == NULL || job->buckets == NULL || job->sums == NULL) {
+        free(job->digits);
+        free(job->buckets);
+        free(job->sums);
+        return false;
+    }
+    return true;
+}
+
+static void msm_job_free(msm_job *job) {
+    free(job->digits);
+    free(job->buckets);
+    free(job->sums);
+}
+
+/**
+ * Get the range of points covered by one part of a linear combination.
+ *
+ * @param[out] lo   The first point in the part
+ * @param[out] hi   One more than the last point in the part
+ * @param[in]  job  The job
+ * @param[in]  part The part, in the range `[0, job->parts)`
+ */
+static void msm_part_range(uint64_t *lo, uint64_t *hi, const msm_job *job, uint64_t part) {
+    *lo = job->len * part / job->parts;
+    *hi = job->len * (part + 1) / job->parts;
+}
+
+/** Recode coefficients `start` to `end - 1` into signed digits, for use with #parallel_for. */
+static void msm_recode_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    msm_job *job = ctx;
+    blst_scalar s;
+    for (uint64_t i = start; i < end; i++) {
+        blst_scalar_from_fr(&s, &job->coeffs[i]);
+        msm_signed_digits(job->digits + i, job->len, &s, job->c, job->num_windows);
+    }
+}
+
+/** Calculate the sum for one window over one part of the points for each task, for use with #parallel_for. */
+static void msm_window_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    msm_job *job = ctx;
+    g1_t *buckets = &job->buckets[thread * job->num_buckets];
+    uint64_t lo, hi;
+    for (uint64_t t = start; t < end; t++) {
+        uint64_t w = t / job->parts;
+        msm_part_range(&lo, &hi, job, t % job->parts);
+        msm_clear_buckets(buckets, job->num_buckets);
+        msm_fill_buckets(buckets, &job->p[lo], &job->digits[w * job->len + lo], hi - lo);
+        msm_sum_buckets(&job->sums[t], buckets, job->num_buckets);
+    }
+}
+
+/**
+ * Calculate a linear combination of G1 group elements in affine coordinates.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
+ *
+ * This uses the Pippenger bucket method with signed digits, with a window size chosen according to @p len. For tiny
+ * inputs, or if we fail to allocate the working space, we fall back to one scalar multiplication per point.
+ *
+ * The work is shared between @p num_threads threads by window. When there are too few windows to go round, the points
+ * are split into ranges as well. The partial sums are always combined in the same order, so the result does not depend
+ * on thread scheduling.
+ *
+ * See [Notes from Mamy](https://github.com/vacp2p/research/issues/7#issuecomment-690083000) for background.
+ *
+ * @param[out] out         The resulting sum-product
+ * @param[in]  p           Array of affine G1 group elements, length @p len
+ * @param[in]  coeffs      Array of field elements, length @p len
+ * @param[in]  len         The number of group/field elements
+ * @param[in]  num_threads The number of threads to use
+ */
+void g1_linear_combination_affine(g1_t *out, const g1_affine_t *p, const fr_t *coeffs, const uint64_t len,
+                                  int num_threads) {
+    msm_job job;
+    uint64_t num_tasks = 0;
+
+    if (len >= MSM_MIN_LEN) {
+        job.p = p;
+        job.p_stride = 0;
+        job.coeffs = coeffs;
+        job.len = len;
+        job.c = msm_window_bits(len);
+        job.num_windows = msm_num_windows(job.c);
+        job.num_buckets = (uint64_t)1 << (job.c - 1);
+        // Aim for a few tasks per thread to even out the load, but don't make the ranges tiny
+        job.parts = (MSM_TASKS_PER_THREAD * parallel_num_threads(num_threads, len) + job.num_windows - 1) /
+                    job.num_windows;
+        if (job.parts > len / MSM_MIN_LEN) job.parts = len / MSM_MIN_LEN;
+        num_tasks = job.num_windows * job.parts;
+        job.num_threads = parallel_num_threads(num_threads, num_tasks);
+    }
+    if (len < MSM_MIN_LEN || !msm_job_alloc(&job, num_tasks)) {
+        g1_t tmp;
+        *out = g1_identity;
+        for (uint64_t i = 0; i < len; i++) {
+            g1_from_affine(&tmp, &p[i]);
+            g1_mul(&tmp, &tmp, &coeffs[i]);
+            blst_p1_add_or_double(out, out, &tmp);
+        }
+        return;
+    }
+
+    parallel_for(msm_recode_task, &job, len, job.num_threads);
+    parallel_for(msm_window_task, &job, num_tasks, job.num_threads);
+
+    // Horner's method over the windows, most significant first
+    *out = g1_identity;
+    for (int w = job.num_windows - 1; w >= 0; w--) {
+        for (int i = 0; i < job.c && !blst_p1_is_inf(out); i++) {
+            blst_p1_double(out, out);
+        }
+        for (uint64_t j = 0; j < job.parts; j++) {
+            blst_p1_add_or_double(out, out, &job.sums[w * job.parts + j]);
+        }
+    }
+
+    msm_job_free(&job);
+}
+
+/**
+ * Calculate a linear combination of G1 group elements using several threads.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
+ *
+ * The points are converted to affine coordinates in one batch, and the work done by #g1_linear_combination_affine.
+ * For tiny inputs, or if we fail to allocate the working space, we fall back to #g1_linear_combination_slow.
+ *
+ * @param[out] out         The resulting sum-product
+ * @param[in]  p           Array of G1 group elements, length @p len
+ * @param[in]  coeffs      Array of field elements, length @p len
+ * @param[in]  len         The number of group/field elements
+ * @param[in]  num_threads The number of threads to use
+ */
+void g1_linear_combination_parallel(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len,
+                                    int num_threads) {
+    g1_affine_t *p_affine;
+
+    if (len < MSM_MIN_LEN || (p_affine = malloc(len * sizeof *p_affine)) == NULL) {
+        g1_linear_combination_slow(out, p, coeffs, len);
+        return;
+    }
+
+    g1_to_affine(p_affine, p, len);
+    g1_linear_combination_affine(out, p_affine, coeffs, len, num_threads);
+
+    free(p_affine);
+}
+
+/**
+ * Calculate a linear combination of G1 group elements.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
+ *
+ * This is the single-threaded version of #g1_linear_combination_parallel.
+ *
+ * @param[out] out    The resulting sum-product
+ * @param[in]  p      Array of G1 group elements, length @p len
+ * @param[in]  coeffs Array of field elements, length @p len
+ * @param[in]  len    The number of group/field elements
+ */
+void g1_linear_combination(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
+    g1_linear_combination_parallel(out, p, coeffs, len, 1);
+}
+
+/**
+ * The number of G1 group elements in a fixed-base table.
+ *
+ * @param[in] len         The number of base points
+ * @param[in] window_bits The window size of the table in bits
+ * @return The number of G1 group elements needed to hold the table
+ */
+uint64_t g1_fixed_base_table_size(uint64_t len, int window_bits) {
+    return msm_num_windows(window_bits) * len;
+}
+
+/**
+ * Choose the window size for a fixed-base table that fits within a memory budget.
+ *
+ * With a fixed-base table there is only one set of buckets to sum per linear combination, rather than one per window,
+ * so the cost is about `num_windows * len + 2^c` additions. Larger windows also need smaller tables.
+ *
+ * @param[in] len        The number of base points
+ * @param[in] max_points The maximum number of G1 group elements the table may occupy
+ * @return The window size in bits, or zero if no table fits within @p max_points
+ */
+int g1_fixed_base_window_bits(uint64_t len, uint64_t max_points) {
+    int best_c = 0;
+    uint64_t best_cost = UINT64_MAX;
+    for (int c = 2; c <= MSM_MAX_WINDOW_BITS; c++) {
+        uint64_t size = g1_fixed_base_table_size(len, c);
+        uint64_t cost = size + ((uint64_t)1 << c);
+        if (size <= max_points && cost < best_cost) {
+            best_cost = cost;
+            best_c = c;
+        }
+    }
+    return best_c;
+}
+
+/**
+ * Precompute a fixed-base table for a set of G1 points.
+ *
+ * The table holds the points multiplied by each power of two that starts a window: `table[w * len + i]` is
+ * `[2^(w * window_bits)]p_i`. The first row is therefore the points themselves. The table is stored in affine
+ * coordinates, with each row converted in a single batch.
+ *
+ * @param[out] table       The table, of size `g1_fixed_base_table_size(len, window_bits)`
+ * @param[in]  p           Array of affine G1 group elements, length @p len
+ * @param[in]  len         The number of base points
+ * @param[in]  window_bits The window size in bits, as chosen by #g1_fixed_base_window_bits
+ * @return `true` if all is well, or `false` if we failed to allocate the working space
+ */
+bool g1_fixed_base_precompute(g1_affine_t *table, const g1_affine_t *p, uint64_t len, int window_bits) {
+    int num_windows = msm_num_windows(window_bits);
+    g1_t *row = malloc(len * sizeof *row);
+    if (row == NULL && len > 0) return false;
+
+    for (uint64_t i = 0; i < len; i++) {
+        table[i] = p[i];
+        g1_from_affine(&row[i], &p[i]);
+    }
+    for (int w = 1; w < num_windows; w++) {
+        for (uint64_t i = 0; i < len; i++) {
+            for (int j = 0; j < window_bits; j++) {
+                blst_p1_double(&row[i], &row[i]);
+            }
+        }
+        g1_to_affine(&table[w * len], row, len);
+    }
+
+    free(row);
+    return true;
+}
+
+/** Sum all the windows over one part of the points for each task, for use with #parallel_for. */
+static void msm_fixed_base_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    msm_job *job = ctx;
+    g1_t *buckets = &job->buckets[thread * job->num_buckets];
+    uint64_t lo, hi;
+    for (uint64_t t = start; t < end; t++) {
+        msm_part_range(&lo, &hi, job, t);
+        msm_clear_buckets(buckets, job->num_buckets);
+        for (int w = 0; w < job->num_windows; w++) {
+            msm_fill_buckets(buckets, &job->p[w * job->p_stride + lo], &job->digits[w * job->len + lo], hi - lo);
+        }
+        msm_sum_buckets(&job->sums[t], buckets, job->num_buckets);
+    }
+}
+
+/**
+ * Calculate a linear combination of G1 group elements using a fixed-base table.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`, and the `p_i` are the
+ * points that @p table was made from. Since the table already contains the shifted points for every window, all the
+ * windows share a single set of buckets and no doublings are needed.
+ *
+ * When @p len is small compared to the number of buckets this would be slower than #g1_linear_combination_affine, so
+ * we use that instead on the first row of the table.
+ *
+ * The work is shared between @p num_threads threads by splitting the points into ranges, each with its own buckets.
+ * The partial sums are combined in a fixed order.
+ *
+ * @param[out] out         The resulting sum-product
+ * @param[in]  table       A table previously computed by #g1_fixed_base_precompute
+ * @param[in]  table_len   The number of base points in @p table
+ * @param[in]  window_bits The window size @p table was computed with
+ * @param[in]  coeffs      Array of field elements, length @p len
+ * @param[in]  len         The number of field elements, at most @p table_len
+ * @param[in]  num_threads The number of threads to use
+ */
+void g1_fixed_base_linear_combination(g1_t *out, const g1_affine_t *table, uint64_t table_len, int window_bits,
+                                      const fr_t *coeffs, uint64_t len, int num_threads) {
+    msm_job job;
+
+    job.p = table;
+    job.p_stride = table_len;
+    job.coeffs = coeffs;
+    job.len = len;
+    job.c = window_bits;
+    job.num_windows = msm_num_windows(window_bits);
+    job.num_buckets = (uint64_t)1 << (window_bits - 1);
+
+    job.num_threads = parallel_num_threads(num_threads, len / MSM_MIN_LEN);
+    if (len < MSM_MIN_LEN ||
+        msm_cost(len, msm_window_bits(len)) <= job.num_windows * len + 2 * job.num_buckets * job.num_threads) {
+        g1_linear_combination_affine(out, table, coeffs, len, num_threads);
+        return;
+    }
+
+    job.parts = job.num_threads;
+    if (!msm_job_alloc(&job, job.parts)) {
+        g1_linear_combination_affine(out, table, coeffs, len, num_threads);
+        return;
+    }
+
+    parallel_for(msm_recode_task, &job, len, job.num_threads);
+    parallel_for(msm_fixed_base_task, &job, job.parts, job.num_threads);
+
+    *out = g1_identity;
+    for (uint64_t j = 0; j < job.parts; j++) {
+        blst_p1_add_or_double(out, out, &job.sums[j]);
+    }
+
+    msm_job_free(&job);
+}
+
+/** The number of pairs that #pairings_verify_n converts to affine in each batch. */
+#define PAIRING_BATCH 16
+
+/**
+ * Perform a product of pairings and test whether the outcome is the identity in G_T.
+ *
+ * Tests whether `e(g1s_0, g2s_0) * e(g1s_1, g2s_1) * ... * e(g1s_n, g2s_n) == 1` where `n` is `len - 1`.
+ *
+ * The Miller loops are all accumulated into one product, so there is only a single final exponentiation. The points
+ * are converted to affine in batches, with one field inversion per batch. Pairs containing a point at infinity
+ * contribute nothing to the product, and are skipped.
+ *
+ * @param[in] g1s Array of G1 group points, length @p len
+ * @param[in] g2s Array of G2 group points, length @p len
+ * @param[in] len The number of pairs
+ * @retval true  The product of the pairings was one
+ * @retval false The product of the pairings was not one
+ */
+bool pairings_verify_n(const g1_t *g1s, const g2_t *g2s, uint64_t len) {
+    blst_fp12 loop, gt_point = *blst_fp12_one();
+    const blst_p1 *p1s[PAIRING_BATCH];
+    const blst_p2 *p2s[PAIRING_BATCH];
+    blst_p1_affine aff1[PAIRING_BATCH];
+    blst_p2_affine aff2[PAIRING_BATCH];
+    uint64_t i = 0;
+
+    while (i < len) {
+        int batch = 0;
+        for (; i < len && batch < PAIRING_BATCH; i++) {
+            if (!blst_p1_is_inf(&g1s[i]) && !blst_p2_is_inf(&g2s[i])) {
+                p1s[batch] = &g1s[i];
+                p2s[batch] = &g2s[i];
+                batch++;
+            }
+        }
+        if (batch == 0) continue;
+        blst_p1s_to_affine(aff1, p1s, batch);
+        blst_p2s_to_affine(aff2, p2s, batch);
+        for (int j = 0; j < batch; j++) {
+            blst_miller_loop(&loop, &aff2[j], &aff1[j]);
+            blst_fp12_mul(&gt_point, &gt_point, &loop);
+        }
+    }
+    blst_final_exp(&gt_point, &gt_point);
+
+    return blst_fp12_is_one(&gt_point);
+}
+
 /**
  * Perform pairings and test whether the outcomes are equal in G_T.
  *
@@ -403,24 +1790,56 @@ void g1_linear_combination(g1_t *out, const g1_t *p, const fr_t *coeffs, const u
  * @retval false The pairings were not equal
  */
 bool pairings_verify(const g1_t *a1, const g2_t *a2, const g1_t *b1, const g2_t *b2) {
-    blst_fp12 loop0, loop1, gt_point;
-    blst_p1_affine aa1, bb1;
-    blst_p2_affine aa2, bb2;
+    g1_t g1s[2] = {*a1, *b1};
+    g2_t g2s[2] = {*a2, *b2};
 
     // As an optimisation, we want to invert one of the pairings,
     // so we negate one of the points.
+    blst_p1_cneg(&g1s[0], true);
+
+    return pairings_verify_n(g1s, g2s, 2);
+}
+
+/**
+ * Perform pairings with prepared G2 points and test whether the outcomes are equal in G_T.
+ *
+ * Tests whether `e(a1, a2) == e(b1, b2)`. This is the same as #pairings_verify, but the G2 half of each Miller loop
+ * has already been done by #g2_prepare.
+ *
+ * @param[in] a1 A G1 group point for the first pairing
+ * @param[in] a2 A prepared G2 group point for the first pairing
+ * @param[in] b1 A G1 group point for the second pairing
+ * @param[in] b2 A prepared G2 group point for the second pairing
+ * @retval true  The pairings were equal
+ * @retval false The pairings were not equal
+ */
+bool pairings_verify_prepared(const g1_t *a1, const g2_prepared_t *a2, const g1_t *b1, const g2_prepared_t *b2) {
+    blst_fp12 loop, gt_point = *blst_fp12_one();
     g1_t a1neg = *a1;
-    blst_p1_cneg(&a1neg, true);
+    const g1_t *g1s[2] = {&a1neg, b1};
+    const g2_prepared_t *g2s[2] = {a2, b2};
+    const blst_p1 *p1s[2];
+    const g2_prepared_t *lines[2];
+    blst_p1_affine aff1[2];
+    int n = 0;
 
-    blst_p1_to_affine(&aa1, &a1neg);
-    blst_p1_to_affine(&bb1, b1);
-    blst_p2_to_affine(&aa2, a2);
-    blst_p2_to_affine(&bb2, b2);
+    // As in pairings_verify(), we invert the first pairing by negating its G1 point
+    blst_p1_cneg(&a1neg, true);
 
-    blst_miller_loop(&loop0, &aa2, &aa1);
-    blst_miller_loop(&loop1, &bb2, &bb1);
+    // Pairs with a point at infinity contribute nothing
+    for (int i = 0; i < 2; i++) {
+        if (!g2s[i]->is_inf && !blst_p1_is_inf(g1s[i])) {
+            p1s[n] = g1s[i];
+            lines[n] = g2s[i];
+            n++;
+        }
+    }
+    if (n > 0) blst_p1s_to_affine(aff1, p1s, n);
 
-    blst_fp12_mul(&gt_point, &loop0, &loop1);
+    for (int i = 0; i < n; i++) {
+        blst_miller_loop_lines(&loop, lines[i]->lines, &aff1[i]);
+        blst_fp12_mul(&gt_point, &gt_point, &loop);
+    }
     blst_final_exp(&gt_point, &gt_point);
 
     return blst_fp12_is_one(&gt_point);
@@ -23,6 +23,7 @@
 #ifndef BLS12_381_H
 #define BLS12_381_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -36,12 +37,40 @@
 
 #include "../inc/blst.h"
 
-typedef blst_scalar scalar_t; /**< Internal scalar type */
-typedef blst_fr fr_t;         /**< Internal Fr field element type */
-typedef blst_fp fp_t;         /**< Internal Fp field element type (used only for debugging) */
-typedef blst_fp2 fp2_t;       /**< Internal Fp2 field element type (used only for debugging) */
-typedef blst_p1 g1_t;         /**< Internal G1 group element type */
-typedef blst_p2 g2_t;         /**< Internal G2 group element type */
+typedef blst_scalar scalar_t;       /**< Internal scalar type */
+typedef blst_fr fr_t;               /**< Internal Fr field element type */
+typedef blst_fp fp_t;               /**< Internal Fp field element type (used only for debugging) */
+typedef blst_fp2 fp2_t;             /**< Internal Fp2 field element type (used only for debugging) */
+typedef blst_p1 g1_t;               /**< Internal G1 group element type */
+typedef blst_p2 g2_t;               /**< Internal G2 group element type */
+typedef blst_p1_affine g1_affine_t; /**< Internal G1 group element type, in affine coordinates */
+
+/**
+ * A G2 group element prepared for use in pairings.
+ *
+ * Holds the precomputed line functions of the Miller loop, so that pairings with a fixed G2 point are cheaper.
+ * Initialise with #g2_prepare.
+ */
+typedef struct {
+    blst_fp6 lines[68]; /**< The Miller loop line coefficients */
+    bool is_inf;        /**< Whether the point is the identity, in which case `lines` is unused */
+} g2_prepared_t;
+
+/** Maximum number of wNAF digits of a GLV half-scalar in #g1_mul: 128 bits plus a final carry. */
+#define G1_MUL_MAX_DIGITS 130
+
+/**
+ * A field element recoded for multiplying G1 group elements.
+ *
+ * Holds the wNAF digits of the two halves of the GLV split that #g1_mul works from, so that a scalar used many times
+ * need only be recoded once. Initialise with #g1_mul_recode and use with #g1_mul_recoded.
+ */
+typedef struct {
+    int8_t d1[G1_MUL_MAX_DIGITS]; /**< wNAF digits of the low half, least significant first */
+    int8_t d2[G1_MUL_MAX_DIGITS]; /**< wNAF digits of the high half, least significant first */
+    uint8_t len1;                 /**< The number of digits of the low half */
+    uint8_t len2;                 /**< The number of digits of the high half */
+} g1_mul_recoding_t;
 
 static const fr_t fr_zero = {0L, 0L, 0L, 0L};
 
@@ -54,6 +83,9 @@ static const fr_t fr_null = {0xffffffffffffffffL, 0xffffffffffffffffL, 0xfffffff
 // The G1 identity/infinity
 static const g1_t g1_identity = {{0L, 0L, 0L, 0L, 0L, 0L}, {0L, 0L, 0L, 0L, 0L, 0L}, {0L, 0L, 0L, 0L, 0L, 0L}};
 
+// The G1 identity/infinity in affine coordinates
+static const g1_affine_t g1_affine_identity = {{0L, 0L, 0L, 0L, 0L, 0L}, {0L, 0L, 0L, 0L, 0L, 0L}};
+
 static const g1_t g1_generator = {{0x5cb38790fd530c16L, 0x7817fc679976fff5L, 0x154f95c7143ba1c1L, 0xf0ae6acdf3d0e747L,
                                    0xedce6ecc21dbf440L, 0x120177419e0bfb75L},
                                   {0xbaac93d50ce72271L, 0x8c22631a7918fd8eL, 0xdd595f13570725ceL, 0x51ac582950405194L,
@@ -101,29 +133,60 @@ int log_2_byte(byte b);
 bool fr_is_zero(const fr_t *p);
 bool fr_is_one(const fr_t *p);
 bool fr_is_null(const fr_t *p);
+uint64_t fr_find_zero(uint64_t *out, const fr_t *a, uint64_t len);
+uint64_t fr_find_null(uint64_t *out, const fr_t *a, uint64_t len);
 void fr_from_scalar(fr_t *out, const scalar_t *a);
 void fr_from_uint64s(fr_t *out, const uint64_t *vals);
 void fr_from_uint64(fr_t *out, uint64_t n);
+void fr_to_bytes(byte out[32], const fr_t *a);
+void fr_from_hash(fr_t *out, const byte *msg, size_t len);
 bool fr_equal(const fr_t *aa, const fr_t *bb);
 void fr_negate(fr_t *out, const fr_t *in);
 void fr_add(fr_t *out, const fr_t *a, const fr_t *b);
 void fr_sub(fr_t *out, const fr_t *a, const fr_t *b);
 void fr_mul(fr_t *out, const fr_t *a, const fr_t *b);
 void fr_inv(fr_t *out, const fr_t *a);
+void fr_batch_inv(fr_t *out, const fr_t *a, uint64_t len);
 void fr_div(fr_t *out, const fr_t *a, const fr_t *b);
 void fr_sqr(fr_t *out, const fr_t *a);
 void fr_pow(fr_t *out, const fr_t *a, uint64_t n);
+void fr_vec_add(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n);
+void fr_vec_sub(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n);
+void fr_vec_mul(fr_t *out, const fr_t *a, const fr_t *b, uint64_t n);
+void fr_vec_scale(fr_t *out, const fr_t *a, const fr_t *s, uint64_t n);
+void fr_vec_butterfly(fr_t *a, fr_t *b, const fr_t *w, uint64_t w_stride, uint64_t n);
+void fr_vec_butterfly_dif(fr_t *a, fr_t *b, const fr_t *w, uint64_t w_stride, uint64_t n);
 bool g1_is_inf(const g1_t *a);
 void g1_dbl(g1_t *out, const g1_t *a);
 void g1_add_or_dbl(g1_t *out, const g1_t *a, const g1_t *b);
 bool g1_equal(const g1_t *a, const g1_t *b);
 void g1_mul(g1_t *out, const g1_t *a, const fr_t *b);
+void g1_mul_recode(g1_mul_recoding_t *out, const fr_t *b);
+void g1_mul_recoded(g1_t *out, const g1_t *a, const g1_mul_recoding_t *b);
 void g1_sub(g1_t *out, const g1_t *a, const g1_t *b);
+void g1_to_bytes(byte out[48], const g1_t *a);
+void g1_to_affine(g1_affine_t *out, const g1_t *in, uint64_t len);
+void g1_from_affine(g1_t *out, const g1_affine_t *in);
+void g1_add_affine(g1_t *out, const g1_t *a, const g1_affine_t *b);
+void g1_affine_butterfly_pass(g1_affine_t *x, uint64_t n, uint64_t h);
 bool g2_equal(const g2_t *a, const g2_t *b);
 void g2_mul(g2_t *out, const g2_t *a, const fr_t *b);
 void g2_sub(g2_t *out, const g2_t *a, const g2_t *b);
 void g2_dbl(g2_t *out, const g2_t *a);
+void g2_prepare(g2_prepared_t *out, const g2_t *a);
+void g1_linear_combination_slow(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len);
+void g1_linear_combination_affine(g1_t *out, const g1_affine_t *p, const fr_t *coeffs, const uint64_t len,
+                                  int num_threads);
+void g1_linear_combination_parallel(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len,
+                                    int num_threads);
 void g1_linear_combination(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len);
+uint64_t g1_fixed_base_table_size(uint64_t len, int window_bits);
+int g1_fixed_base_window_bits(uint64_t len, uint64_t max_points);
+bool g1_fixed_base_precompute(g1_affine_t *table, const g1_affine_t *p, uint64_t len, int window_bits);
+void g1_fixed_base_linear_combination(g1_t *out, const g1_affine_t *table, uint64_t table_len, int window_bits,
+                                      const fr_t *coeffs, uint64_t len, int num_threads);
+bool pairings_verify_n(const g1_t *g1s, const g2_t *g2s, uint64_t len);
 bool pairings_verify(const g1_t *a1, const g2_t *a2, const g1_t *b1, const g2_t *b2);
+bool pairings_verify_prepared(const g1_t *a1, const g2_prepared_t *a2, const g1_t *b1, const g2_prepared_t *b2);
 
 #endif // BLS12_381_H
\ No newline at end of file
@@ -38,12 +38,53 @@ void fr_is_one_works(void) {
     TEST_CHECK(fr_is_one(&fr_one));
 }
 
+void fr_comparisons_of_computed_values(void) {
+    // The results of arithmetic are compared correctly without leaving Montgomery form
+    fr_t a = rand_fr(), b, c;
+    fr_inv(&b, &a);
+    fr_mul(&c, &a, &b);
+    TEST_CHECK(fr_is_one(&c));
+    TEST_CHECK(!fr_is_zero(&c));
+    fr_sub(&c, &a, &a);
+    TEST_CHECK(fr_is_zero(&c));
+    TEST_CHECK(!fr_is_one(&c));
+    fr_add(&b, &a, &fr_one);
+    fr_sub(&c, &b, &fr_one);
+    TEST_CHECK(fr_equal(&a, &c));
+    TEST_CHECK(!fr_equal(&a, &b));
+}
+
 void fr_is_null_works(void) {
     TEST_CHECK(fr_is_null(&fr_null));
     TEST_CHECK(!fr_is_null(&fr_zero));
     TEST_CHECK(!fr_is_null(&fr_one));
 }
 
+void fr_find_works(void) {
+    int len = 37;
+    fr_t a[len];
+    uint64_t idx[len], count;
+
+    for (int i = 0; i < len; i++) {
+        a[i] = i % 3 == 0 ? fr_zero : i % 7 == 0 ? fr_null : fr_one;
+    }
+
+    count = fr_find_zero(idx, a, len);
+    TEST_CHECK(13 == count);
+    for (int i = 0; i < count; i++) {
+        TEST_CHECK(3 * i == idx[i]);
+    }
+
+    count = fr_find_null(idx, a, len);
+    TEST_CHECK(4 == count);
+    TEST_CHECK(7 == idx[0]);
+    TEST_CHECK(14 == idx[1]);
+    TEST_CHECK(28 == idx[2]);
+    TEST_CHECK(35 == idx[3]);
+
+    TEST_CHECK(0 == fr_find_zero(idx, a, 0));
+}
+
 void fr_from_uint64_works(void) {
     fr_t a;
     fr_from_uint64(&a, 1);
@@ -98,6 +139,79 @@ void fr_div_works(void) {
     TEST_CHECK(fr_equal(&a, &actual));
 }
 
+void fr_vec_works(void) {
+    // Long enough to cover whole vectors and a remainder, for any vector width up to 16
+    int len = 37;
+    fr_t a[len], b[len], w[3 * len], out[len], a2[len], b2[len], expected, t;
+
+    for (int i = 0; i < len; i++) {
+        a[i] = rand_fr();
+        b[i] = rand_fr();
+    }
+    for (int i = 0; i < 3 * len; i++) {
+        w[i] = rand_fr();
+    }
+    // Edge values
+    a[0] = fr_zero;
+    b[1] = fr_zero;
+    a[2] = fr_one;
+    fr_negate(&b[2], &fr_one);
+    fr_negate(&a[3], &fr_one);
+    fr_negate(&b[3], &fr_one);
+    w[0] = fr_zero;
+
+    fr_vec_add(out, a, b, len);
+    for (int i = 0; i < len; i++) {
+        fr_add(&expected, &a[i], &b[i]);
+        TEST_CHECK(fr_equal(&expected, &out[i]));
+    }
+    fr_vec_sub(out, a, b, len);
+    for (int i = 0; i < len; i++) {
+        fr_sub(&expected, &a[i], &b[i]);
+        TEST_CHECK(fr_equal(&expected, &out[i]));
+    }
+    fr_vec_mul(out, a, b, len);
+    for (int i = 0; i < len; i++) {
+        fr_mul(&expected, &a[i], &b[i]);
+        TEST_CHECK(fr_equal(&expected, &out[i]));
+        TEST_MSG("Failed at index %d", i);
+    }
+    fr_vec_scale(out, a, &b[3], len);
+    for (int i = 0; i < len; i++) {
+        fr_mul(&expected, &a[i], &b[3]);
+        TEST_CHECK(fr_equal(&expected, &out[i]));
+    }
+
+    // Butterflies, with contiguous, strided and repeated twiddles
+    for (int stride = 0; stride <= 3; stride++) {
+        for (int i = 0; i < len; i++) {
+            a2[i] = a[i];
+            b2[i] = b[i];
+        }
+        fr_vec_butterfly(a2, b2, w, stride, len);
+        for (int i = 0; i < len; i++) {
+            fr_mul(&t, &b[i], &w[i * stride]);
+            fr_add(&expected, &a[i], &t);
+            TEST_CHECK(fr_equal(&expected, &a2[i]));
+            fr_sub(&expected, &a[i], &t);
+            TEST_CHECK(fr_equal(&expected, &b2[i]));
+        }
+
+        for (int i = 0; i < len; i++) {
+            a2[i] = a[i];
+            b2[i] = b[i];
+        }
+        fr_vec_butterfly_dif(a2, b2, w, stride, len);
+        for (int i = 0; i < len; i++) {
+            fr_add(&expected, &a[i], &b[i]);
+            TEST_CHECK(fr_equal(&expected, &a2[i]));
+            fr_sub(&t, &a[i], &b[i]);
+            fr_mul(&expected, &t, &w[i * stride]);
+            TEST_CHECK(fr_equal(&expected, &b2[i]));
+        }
+    }
+}
+
 // This is strictly undefined, but conventionally 0 is returned
 void fr_div_by_zero(void) {
     fr_t a, b, tmp;
@@ -110,6 +224,30 @@ void fr_div_by_zero(void) {
     TEST_CHECK(fr_is_zero(&tmp));
 }
 
+void fr_batch_inv_works(void) {
+    int len = 32;
+    fr_t a[len], inv[len], expected;
+
+    // Include some zeros, which have no inverse
+    for (int i = 0; i < len; i++) {
+        a[i] = i % 5 == 0 ? fr_zero : rand_fr();
+    }
+    fr_batch_inv(inv, a, len);
+    for (int i = 0; i < len; i++) {
+        fr_inv(&expected, &a[i]);
+        TEST_CHECK(fr_equal(&expected, &inv[i]));
+        TEST_MSG("Failed at index %d", i);
+    }
+
+    // Edge cases
+    fr_batch_inv(inv, a, 0);
+    fr_batch_inv(inv, a, 1);
+    TEST_CHECK(fr_is_zero(&inv[0]));
+    fr_batch_inv(inv, a + 1, 1);
+    fr_mul(&expected, &inv[0], &a[1]);
+    TEST_CHECK(fr_is_one(&expected));
+}
+
 void p1_mul_works(void) {
     fr_t minus1;
     g1_t res;
@@ -122,6 +260,72 @@ void p1_mul_works(void) {
     TEST_CHECK(g1_equal(&res, &g1_negative_generator));
 }
 
+void p1_mul_matches_blst(void) {
+    // Scalars around the GLV split, where one half vanishes or the wNAF recoding carries
+    uint64_t vals[][4] = {{0, 0, 0, 0},
+                          {1, 0, 0, 0},
+                          {2, 0, 0, 0},
+                          {15, 0, 0, 0},
+                          {17, 0, 0, 0},
+                          {0x00000000ffffffffL, 0xac45a4010001a402L, 0, 0},
+                          {0x00000000fffffffeL, 0xac45a4010001a402L, 0, 0},
+                          {0x0000000100000000L, 0xac45a4010001a402L, 0, 0},
+                          {0, 0, 1, 0},
+                          {0xffffffffffffffffL, 0xffffffffffffffffL, 0, 0},
+                          {0xffffffff00000000L, 0x53bda402fffe5bfeL, 0x3339d80809a1d805L, 0x73eda753299d7d48L}};
+    int n = sizeof vals / sizeof vals[0];
+    fr_t b;
+    g1_t a, exp, res;
+    blst_scalar s;
+
+    for (int i = 0; i < n + 32; i++) {
+        a = rand_g1();
+        if (i < n) {
+            fr_from_uint64s(&b, vals[i]);
+        } else {
+            b = rand_fr();
+        }
+        blst_scalar_from_fr(&s, &b);
+        blst_p1_mult(&exp, &a, s.b, 256);
+        g1_mul(&res, &a, &b);
+        TEST_CHECK(g1_equal(&exp, &res));
+        TEST_MSG("Failed at %d", i);
+
+        // In place
+        g1_mul(&a, &a, &b);
+        TEST_CHECK(g1_equal(&exp, &a));
+    }
+
+    // The identity
+    b = rand_fr();
+    g1_mul(&res, &g1_identity, &b);
+    TEST_CHECK(g1_is_inf(&res));
+}
+
+void p1_mul_recoded_works(void) {
+    fr_t b;
+    g1_t a, exp, res;
+    g1_mul_recoding_t r;
+
+    for (int i = 0; i < 34; i++) {
+        a = rand_g1();
+        if (i < 2) {
+            fr_from_uint64(&b, i);
+        } else {
+            b = rand_fr();
+        }
+        g1_mul(&exp, &a, &b);
+        g1_mul_recode(&r, &b);
+        g1_mul_recoded(&res, &a, &r);
+        TEST_CHECK(g1_equal(&exp, &res));
+        TEST_MSG("Failed at %d", i);
+
+        // In place, reusing the recoding
+        g1_mul_recoded(&a, &a, &r);
+        TEST_CHECK(g1_equal(&exp, &a));
+    }
+}
+
 void p1_sub_works(void) {
     g1_t tmp, res;
 
@@ -181,6 +385,131 @@ void g1_make_linear_combination(void) {
     TEST_CHECK(g1_equal(&exp, &res));
 }
 
+void g1_random_linear_combination(void) {
+    int len = 300;
+    fr_t coeffs[len];
+    g1_t p[len], exp, res;
+    for (int i = 0; i < len; i++) {
+        coeffs[i] = rand_fr();
+        p[i] = rand_g1();
+    }
+
+    // Cover both the direct method for tiny lengths and the Pippenger method
+    for (int n = 0; n <= len; n += n < 16 ? 1 : 71) {
+        g1_linear_combination_slow(&exp, p, coeffs, n);
+        g1_linear_combination(&res, p, coeffs, n);
+        TEST_CHECK(g1_equal(&exp, &res));
+        TEST_MSG("Failed at length %d", n);
+    }
+}
+
+void g1_parallel_linear_combination(void) {
+    int len = 300;
+    fr_t coeffs[len];
+    g1_t p[len], exp, res;
+    for (int i = 0; i < len; i++) {
+        coeffs[i] = rand_fr();
+        p[i] = rand_g1();
+    }
+
+    // Enough threads to need splitting the windows into ranges of points, and zero threads meaning one
+    for (int n = 0; n <= len; n += n < 16 ? 1 : 71) {
+        g1_linear_combination_slow(&exp, p, coeffs, n);
+        for (int threads = 0; threads <= 64; threads = threads == 0 ? 1 : threads * 4) {
+            g1_linear_combination_parallel(&res, p, coeffs, n, threads);
+            TEST_CHECK(g1_equal(&exp, &res));
+            TEST_MSG("Failed at length %d with %d threads", n, threads);
+        }
+    }
+}
+
+void g1_linear_combination_extreme_coeffs(void) {
+    int len = 64;
+    fr_t coeffs[len], minus1;
+    g1_t p[len], exp, res;
+
+    // Coefficients of zero, one and minus one exercise the edge cases of the signed digit recoding
+    fr_from_uint64s(&minus1, m1);
+    for (int i = 0; i < len; i++) {
+        coeffs[i] = i % 3 == 0 ? fr_zero : i % 3 == 1 ? fr_one : minus1;
+        p[i] = rand_g1();
+    }
+
+    g1_linear_combination_slow(&exp, p, coeffs, len);
+    g1_linear_combination(&res, p, coeffs, len);
+    TEST_CHECK(g1_equal(&exp, &res));
+}
+
+void g1_to_affine_works(void) {
+    int len = 8;
+    g1_t p[len], q;
+    g1_affine_t p_affine[len];
+
+    // Points at infinity need special treatment in the batch conversion
+    for (int i = 0; i < len; i++) {
+        p[i] = i % 3 == 1 ? g1_identity : rand_g1();
+    }
+    p[len - 1] = g1_identity;
+    g1_to_affine(p_affine, p, len);
+    for (int i = 0; i < len; i++) {
+        g1_from_affine(&q, &p_affine[i]);
+        TEST_CHECK(g1_equal(&p[i], &q));
+        TEST_MSG("Failed at index %d", i);
+    }
+}
+
+void g1_add_affine_works(void) {
+    g1_t a = rand_g1(), b = rand_g1(), exp, res;
+    g1_affine_t b_affine;
+
+    g1_to_affine(&b_affine, &b, 1);
+    g1_add_or_dbl(&exp, &a, &b);
+    g1_add_affine(&res, &a, &b_affine);
+    TEST_CHECK(g1_equal(&exp, &res));
+
+    // Doubling
+    g1_to_affine(&b_affine, &a, 1);
+    g1_dbl(&exp, &a);
+    g1_add_affine(&res, &a, &b_affine);
+    TEST_CHECK(g1_equal(&exp, &res));
+}
+
+void g1_fixed_base_linear_combination_works(void) {
+    int len = 300;
+    fr_t coeffs[len];
+    g1_t p[len], exp, res;
+    g1_affine_t p_affine[len];
+    for (int i = 0; i < len; i++) {
+        coeffs[i] = rand_fr();
+        p[i] = rand_g1();
+    }
+    g1_to_affine(p_affine, p, len);
+
+    for (int bits = 4; bits <= 10; bits += 3) {
+        g1_affine_t table[g1_fixed_base_table_size(len, bits)];
+        TEST_CHECK(g1_fixed_base_precompute(table, p_affine, len, bits));
+        // Shorter lengths fall back to the variable-base method on the first row of the table
+        for (int n = 0; n <= len; n += n < 16 ? 1 : 71) {
+            g1_linear_combination_slow(&exp, p, coeffs, n);
+            for (int threads = -1; threads <= 3; threads++) {
+                g1_fixed_base_linear_combination(&res, table, len, bits, coeffs, n, threads);
+                TEST_CHECK(g1_equal(&exp, &res));
+                TEST_MSG("Failed at length %d with %d bits and %d threads", n, bits, threads);
+            }
+        }
+    }
+}
+
+void g1_fixed_base_window_bits_fits(void) {
+    // Even the largest windows need at least 16 rows in the table
+    TEST_CHECK(0 == g1_fixed_base_window_bits(1024, 1024 * 16 - 1));
+    for (uint64_t max = 1024 * 16; max <= 1024 * 256; max *= 2) {
+        int bits = g1_fixed_base_window_bits(1024, max);
+        TEST_CHECK(bits > 0);
+        TEST_CHECK(g1_fixed_base_table_size(1024, bits) <= max);
+    }
+}
+
 void pairings_work(void) {
     // Verify that e([3]g1, [5]g2) = e([5]g1, [3]g2)
     fr_t three, five;
@@ -200,25 +529,96 @@ void pairings_work(void) {
     TEST_CHECK(false == pairings_verify(&g1_3, &g2_3, &g1_5, &g2_5));
 }
 
+void pairings_verify_prepared_works(void) {
+    // Verify that e([3]g1, [5]g2) = e([5]g1, [3]g2) with prepared G2 points
+    fr_t three, five;
+    g1_t g1_3, g1_5;
+    g2_t g2_3, g2_5;
+    g2_prepared_t g2_3_prep, g2_5_prep, identity_prep;
+
+    fr_from_uint64(&three, 3);
+    fr_from_uint64(&five, 5);
+    g1_mul(&g1_3, &g1_generator, &three);
+    g1_mul(&g1_5, &g1_generator, &five);
+    g2_mul(&g2_3, &g2_generator, &three);
+    g2_mul(&g2_5, &g2_generator, &five);
+    g2_prepare(&g2_3_prep, &g2_3);
+    g2_prepare(&g2_5_prep, &g2_5);
+
+    TEST_CHECK(true == pairings_verify_prepared(&g1_3, &g2_5_prep, &g1_5, &g2_3_prep));
+    TEST_CHECK(false == pairings_verify_prepared(&g1_3, &g2_3_prep, &g1_5, &g2_5_prep));
+
+    // Points at infinity on either side
+    g2_mul(&g2_3, &g2_generator, &fr_zero);
+    g2_prepare(&identity_prep, &g2_3);
+    TEST_CHECK(true == identity_prep.is_inf);
+    TEST_CHECK(true == pairings_verify_prepared(&g1_3, &identity_prep, &g1_identity, &g2_5_prep));
+    TEST_CHECK(false == pairings_verify_prepared(&g1_3, &identity_prep, &g1_5, &g2_5_prep));
+}
+
+void pairings_verify_n_works(void) {
+    // Verify that e([a_0]g1, [b_0]g2) * ... * e([a_n]g1, [b_n]g2) == 1 when sum_i a_i * b_i == 0
+    int len = 40;
+    fr_t a, b, ab, sum = fr_zero;
+    g1_t g1s[len];
+    g2_t g2s[len];
+
+    for (int i = 0; i < len - 1; i++) {
+        a = rand_fr();
+        b = rand_fr();
+        fr_mul(&ab, &a, &b);
+        fr_add(&sum, &sum, &ab);
+        g1_mul(&g1s[i], &g1_generator, &a);
+        g2_mul(&g2s[i], &g2_generator, &b);
+    }
+    fr_negate(&sum, &sum);
+    g1_mul(&g1s[len - 1], &g1_generator, &sum);
+    g2s[len - 1] = g2_generator;
+    TEST_CHECK(true == pairings_verify_n(g1s, g2s, len));
+    TEST_CHECK(false == pairings_verify_n(g1s, g2s, len - 1));
+
+    // Pairs with a point at infinity make no difference
+    g1s[3] = g1_identity;
+    g1s[5] = g1_identity;
+    TEST_CHECK(false == pairings_verify_n(g1s, g2s, len));
+    TEST_CHECK(true == pairings_verify_n(g1s + 3, g2s + 3, 1));
+    TEST_CHECK(true == pairings_verify_n(g1s, g2s, 0));
+}
+
 TEST_LIST = {
     {"BLS12_384_TEST", title},
     {"log_2_byte_works", log_2_byte_works},
     {"fr_is_zero_works", fr_is_zero_works},
     {"fr_is_one_works", fr_is_one_works},
+    {"fr_comparisons_of_computed_values", fr_comparisons_of_computed_values},
     {"fr_is_null_works", fr_is_null_works},
+    {"fr_find_works", fr_find_works},
     {"fr_from_uint64_works", fr_from_uint64_works},
     {"fr_equal_works", fr_equal_works},
     {"fr_negate_works", fr_negate_works},
     {"fr_pow_works", fr_pow_works},
     {"fr_div_works", fr_div_works},
     {"fr_div_by_zero", fr_div_by_zero},
+    {"fr_batch_inv_works", fr_batch_inv_works},
+    {"fr_vec_works", fr_vec_works},
     {"p1_mul_works", p1_mul_works},
+    {"p1_mul_matches_blst", p1_mul_matches_blst},
+    {"p1_mul_recoded_works", p1_mul_recoded_works},
     {"p1_sub_works", p1_sub_works},
     {"p2_mul_works", p2_mul_works},
     {"p2_sub_works", p2_sub_works},
     {"g1_identity_is_infinity", g1_identity_is_infinity},
     {"g1_identity_is_identity", g1_identity_is_identity},
     {"g1_make_linear_combination", g1_make_linear_combination},
+    {"g1_random_linear_combination", g1_random_linear_combination},
+    {"g1_parallel_linear_combination", g1_parallel_linear_combination},
+    {"g1_linear_combination_extreme_coeffs", g1_linear_combination_extreme_coeffs},
+    {"g1_to_affine_works", g1_to_affine_works},
+    {"g1_add_affine_works", g1_add_affine_works},
+    {"g1_fixed_base_linear_combination_works", g1_fixed_base_linear_combination_works},
+    {"g1_fixed_base_window_bits_fits", g1_fixed_base_window_bits_fits},
     {"pairings_work", pairings_work},
+    {"pairings_verify_n_works", pairings_verify_n_works},
+    {"pairings_verify_prepared_works", pairings_verify_prepared_works},
     {NULL, NULL} /* zero record marks the end of the list */
 };
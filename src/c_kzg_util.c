@@ -109,6 +109,34 @@ C_KZG_RET new_g1_array_2(g1_t ***x, size_t n) {
     return c_kzg_malloc((void **)x, n * sizeof **x);
 }
 
+/**
+ * Allocate memory for an array of G1 group elements in affine coordinates.
+ *
+ * @remark Free the space later using `free()`.
+ *
+ * @param[out] x Pointer to the allocated space
+ * @param[in]  n The number of G1 elements to be allocated
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET new_g1_affine_array(g1_affine_t **x, size_t n) {
+    return c_kzg_malloc((void **)x, n * sizeof **x);
+}
+
+/**
+ * Allocate memory for an array of arrays of G1 group elements in affine coordinates.
+ *
+ * @remark Free the space later using `free()`, after freeing each of the array's elements.
+ *
+ * @param[out] x Pointer to the allocated space
+ * @param[in]  n The number of G1 arrays to be allocated
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET new_g1_affine_array_2(g1_affine_t ***x, size_t n) {
+    return c_kzg_malloc((void **)x, n * sizeof **x);
+}
+
 /**
  * Allocate memory for an array of G2 group elements.
  *
@@ -123,6 +151,20 @@ C_KZG_RET new_g2_array(g2_t **x, size_t n) {
     return c_kzg_malloc((void **)x, n * sizeof **x);
 }
 
+/**
+ * Allocate memory for an array of prepared G2 group elements.
+ *
+ * @remark Free the space later using `free()`.
+ *
+ * @param[out] x Pointer to the allocated space
+ * @param[in]  n The number of prepared G2 elements to be allocated
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET new_g2_prepared_array(g2_prepared_t **x, size_t n) {
+    return c_kzg_malloc((void **)x, n * sizeof **x);
+}
+
 /**
  * Allocate memory for an array of polynomial headers.
  *
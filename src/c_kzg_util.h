@@ -33,5 +33,8 @@ C_KZG_RET new_fr_array(fr_t **x, size_t n);
 C_KZG_RET new_fr_array_2(fr_t ***x, size_t n);
 C_KZG_RET new_g1_array(g1_t **x, size_t n);
 C_KZG_RET new_g1_array_2(g1_t ***x, size_t n);
+C_KZG_RET new_g1_affine_array(g1_affine_t **x, size_t n);
+C_KZG_RET new_g1_affine_array_2(g1_affine_t ***x, size_t n);
 C_KZG_RET new_g2_array(g2_t **x, size_t n);
+C_KZG_RET new_g2_prepared_array(g2_prepared_t **x, size_t n);
 C_KZG_RET new_poly_array(poly **x, size_t n);
\ No newline at end of file
@@ -21,60 +21,143 @@
  */
 
 #include "das_extension.h"
+#include "parallel.h"
 
 /**
- * Recursive implementation of #das_fft_extension.
+ * The smallest batch, in total elements, that #das_fft_extension_batch spreads over several threads.
+ */
+#define DAS_EXTENSION_PARALLEL_MIN_LEN 4096
+
+/**
+ * The layout of a batch of vectors extended together by #das_fft_extension_batch.
+ *
+ * Element `i` of vector `v` is at `i * elem_stride + v * vec_stride`.
+ */
+typedef struct {
+    fr_t *vals;            /**< The data */
+    uint64_t n;            /**< The length of each vector */
+    uint64_t count;        /**< The number of vectors */
+    uint64_t elem_stride;  /**< The distance between consecutive elements of a vector */
+    uint64_t vec_stride;   /**< The distance between the starts of consecutive vectors */
+    const FFTSettings *fs; /**< The FFT settings */
+} das_batch;
+
+/**
+ * Recursive implementation of #das_fft_extension_batch.
+ *
+ * Each butterfly is applied to the same position of all the vectors with a single load of its root of unity. When the
+ * elements of a vector, or the vectors, are contiguous the butterflies are done with the array kernels such as
+ * #fr_vec_butterfly.
  *
  * @param[in, out] ab     Input: values of the even indices. Output: values of the odd indices (in-place)
- * @param[in]      n      The length of @p ab
+ * @param[in]      n      The length of the vectors in @p ab
  * @param[in]      stride The step length through the roots of unity
- * @param[in]      fs     The FFT settings previously initialised with #new_fft_settings
+ * @param[in]      batch  The layout of the vectors, and the FFT settings
  */
-static void das_fft_extension_stride(fr_t *ab, uint64_t n, uint64_t stride, const FFTSettings *fs) {
+static void das_fft_extension_stride(fr_t *ab, uint64_t n, uint64_t stride, const das_batch *batch) {
+    uint64_t even_stride, odd_stride;
+    const fr_t *even_roots, *odd_roots;
+    const FFTSettings *fs = batch->fs;
+    uint64_t es = batch->elem_stride, vs = batch->vec_stride;
 
     if (n < 2) return;
 
+    // Powers of the root at twice and once the stride, with contiguous per-stage tables when available
+    even_roots = fft_stage_roots(&even_stride, fs, true, fs->max_width / (4 * stride));
+    odd_roots = fft_stage_roots(&odd_stride, fs, false, fs->max_width / (2 * stride));
+
     if (n == 2) {
-        fr_t x, y, tmp;
-        fr_add(&x, &ab[0], &ab[1]);
-        fr_sub(&y, &ab[0], &ab[1]);
-        fr_mul(&tmp, &y, &fs->expanded_roots_of_unity[stride]);
-        fr_add(&ab[0], &x, &tmp);
-        fr_sub(&ab[1], &x, &tmp);
+        for (uint64_t v = 0; v < batch->count; v++) {
+            fr_t x, y, tmp;
+            fr_t *ab0 = ab + v * vs, *ab1 = ab + es + v * vs;
+            fr_add(&x, ab0, ab1);
+            fr_sub(&y, ab0, ab1);
+            fr_mul(&tmp, &y, &odd_roots[odd_stride]);
+            fr_add(ab0, &x, &tmp);
+            fr_sub(ab1, &x, &tmp);
+        }
     } else {
         uint64_t half = n, halfhalf = half / 2;
         fr_t *ab_half_0s = ab;
-        fr_t *ab_half_1s = ab + halfhalf;
+        fr_t *ab_half_1s = ab + halfhalf * es;
 
         // Modify ab_half_* in-place, rather than allocating L0 and L1 arrays.
         // L0[i] = (((a_half0 + a_half1) % modulus) * inv2) % modulus
         // R0[i] = (((a_half0 - L0[i]) % modulus) * inverse_domain[i * 2]) % modulus
-        for (uint64_t i = 0; i < halfhalf; i++) {
-            fr_t tmp1, tmp2;
-            fr_t *a_half_0 = ab_half_0s + i;
-            fr_t *a_half_1 = ab_half_1s + i;
-            fr_add(&tmp1, a_half_0, a_half_1);
-            fr_sub(&tmp2, a_half_0, a_half_1);
-            fr_mul(a_half_1, &tmp2, &fs->reverse_roots_of_unity[i * 2 * stride]);
-            *a_half_0 = tmp1;
+        if (es == 1) {
+            for (uint64_t v = 0; v < batch->count; v++) {
+                fr_vec_butterfly_dif(ab_half_0s + v * vs, ab_half_1s + v * vs, even_roots, even_stride, halfhalf);
+            }
+        } else {
+            for (uint64_t i = 0; i < halfhalf; i++) {
+                const fr_t *root = &even_roots[i * even_stride];
+                fr_t *a_half_0 = ab_half_0s + i * es, *a_half_1 = ab_half_1s + i * es;
+                if (vs == 1) {
+                    fr_vec_butterfly_dif(a_half_0, a_half_1, root, 0, batch->count);
+                    continue;
+                }
+                for (uint64_t v = 0; v < batch->count; v++) {
+                    fr_t tmp1, tmp2;
+                    fr_add(&tmp1, &a_half_0[v * vs], &a_half_1[v * vs]);
+                    fr_sub(&tmp2, &a_half_0[v * vs], &a_half_1[v * vs]);
+                    fr_mul(&a_half_1[v * vs], &tmp2, root);
+                    a_half_0[v * vs] = tmp1;
+                }
+            }
         }
 
         // Recurse
-        das_fft_extension_stride(ab_half_0s, halfhalf, stride * 2, fs);
-        das_fft_extension_stride(ab_half_1s, halfhalf, stride * 2, fs);
+        das_fft_extension_stride(ab_half_0s, halfhalf, stride * 2, batch);
+        das_fft_extension_stride(ab_half_1s, halfhalf, stride * 2, batch);
 
         // The odd deduced outputs are written to the output array already, but then updated in-place
         // L1 = b[:halfHalf]
         // R1 = b[halfHalf:]
 
-        for (uint64_t i = 0; i < halfhalf; i++) {
-            fr_t y_times_root;
-            fr_t x = ab_half_0s[i];
-            fr_t y = ab_half_1s[i];
-            fr_mul(&y_times_root, &y, &fs->expanded_roots_of_unity[(1 + 2 * i) * stride]);
-            // write outputs in place, avoid unnecessary list allocations
-            fr_add(&ab_half_0s[i], &x, &y_times_root);
-            fr_sub(&ab_half_1s[i], &x, &y_times_root);
+        if (es == 1) {
+            for (uint64_t v = 0; v < batch->count; v++) {
+                fr_vec_butterfly(ab_half_0s + v * vs, ab_half_1s + v * vs, &odd_roots[odd_stride], 2 * odd_stride,
+                                 halfhalf);
+            }
+        } else {
+            for (uint64_t i = 0; i < halfhalf; i++) {
+                const fr_t *root = &odd_roots[(1 + 2 * i) * odd_stride];
+                fr_t *a_half_0 = ab_half_0s + i * es, *a_half_1 = ab_half_1s + i * es;
+                if (vs == 1) {
+                    fr_vec_butterfly(a_half_0, a_half_1, root, 0, batch->count);
+                    continue;
+                }
+                for (uint64_t v = 0; v < batch->count; v++) {
+                    fr_t y_times_root;
+                    fr_t x = a_half_0[v * vs];
+                    fr_mul(&y_times_root, &a_half_1[v * vs], root);
+                    // write outputs in place, avoid unnecessary list allocations
+                    fr_add(&a_half_0[v * vs], &x, &y_times_root);
+                    fr_sub(&a_half_1[v * vs], &x, &y_times_root);
+                }
+            }
+        }
+    }
+}
+
+static void das_fft_extension_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    das_batch sub = *(das_batch *)ctx;
+    fr_t invlen;
+
+    sub.vals += start * sub.vec_stride;
+    sub.count = end - start;
+    das_fft_extension_stride(sub.vals, sub.n, 1, &sub);
+
+    fr_from_uint64(&invlen, sub.n);
+    fr_inv(&invlen, &invlen);
+    for (uint64_t v = 0; v < sub.count; v++) {
+        if (sub.elem_stride == 1) {
+            fr_vec_scale(sub.vals + v * sub.vec_stride, sub.vals + v * sub.vec_stride, &invlen, sub.n);
+            continue;
+        }
+        for (uint64_t i = 0; i < sub.n; i++) {
+            fr_t *x = sub.vals + i * sub.elem_stride + v * sub.vec_stride;
+            fr_mul(x, x, &invlen);
         }
     }
 }
@@ -94,18 +177,44 @@ static void das_fft_extension_stride(fr_t *ab, uint64_t n, uint64_t stride, cons
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  */
 C_KZG_RET das_fft_extension(fr_t *vals, uint64_t n, const FFTSettings *fs) {
-    fr_t invlen;
-
     CHECK(n * 2 <= fs->max_width);
     CHECK(n >= 2);
 
-    das_fft_extension_stride(vals, n, 1, fs);
+    das_batch batch = {.vals = vals, .n = n, .count = 1, .elem_stride = 1, .vec_stride = n, .fs = fs};
+    das_fft_extension_task(&batch, 0, 0, 1);
 
-    fr_from_uint64(&invlen, n);
-    fr_inv(&invlen, &invlen);
-    for (uint64_t i = 0; i < n; i++) {
-        fr_mul(&vals[i], &vals[i], &invlen);
-    }
+    return C_KZG_OK;
+}
+
+/**
+ * Perform polynomial extension for data availability sampling on a batch of vectors of the same length.
+ *
+ * As #das_fft_extension, for each of @p count vectors. Element `i` of vector `v` is at
+ * `vals[i * elem_stride + v * vec_stride]`, so row-major data has `elem_stride = 1` and interleaved data has
+ * `vec_stride = 1`. The vectors must not overlap.
+ *
+ * Each root of unity is loaded once and applied to all the vectors. When the batch is large, the vectors are shared
+ * out between `fs->num_threads` threads. Set this to one to do the whole batch on the calling thread.
+ *
+ * @param[in, out] vals        Input: values of the even indices. Output: values of the odd indices (in place)
+ * @param[in]      n           The length of each vector
+ * @param[in]      count       The number of vectors
+ * @param[in]      elem_stride The distance between consecutive elements of a vector
+ * @param[in]      vec_stride  The distance between the starts of consecutive vectors
+ * @param[in]      fs          The FFT settings previously initialised with #new_fft_settings
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ */
+C_KZG_RET das_fft_extension_batch(fr_t *vals, uint64_t n, uint64_t count, uint64_t elem_stride, uint64_t vec_stride,
+                                  const FFTSettings *fs) {
+    int num_threads = n * count >= DAS_EXTENSION_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+
+    CHECK(n * 2 <= fs->max_width);
+    CHECK(n >= 2);
+
+    das_batch batch = {
+        .vals = vals, .n = n, .count = count, .elem_stride = elem_stride, .vec_stride = vec_stride, .fs = fs};
+    parallel_for(das_fft_extension_task, &batch, count, num_threads);
 
     return C_KZG_OK;
-}
\ No newline at end of file
+}
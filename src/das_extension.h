@@ -24,3 +24,5 @@
 #include "fft_common.h"
 
 C_KZG_RET das_fft_extension(fr_t *vals, uint64_t n, const FFTSettings *fs);
+C_KZG_RET das_fft_extension_batch(fr_t *vals, uint64_t n, uint64_t count, uint64_t elem_stride, uint64_t vec_stride,
+                                  const FFTSettings *fs);
@@ -99,9 +99,70 @@ void das_extension_test_random(void) {
     }
 }
 
+void das_extension_test_stage_roots(void) {
+    FFTSettings fs1, fs2;
+    uint64_t half;
+    TEST_CHECK(C_KZG_OK == new_fft_settings(&fs1, 8));
+    TEST_CHECK(C_KZG_OK == new_fft_settings(&fs2, 8));
+    TEST_CHECK(C_KZG_OK == precompute_fft_settings(&fs2));
+    half = fs1.max_width / 2;
+
+    fr_t data1[half], data2[half];
+    for (uint64_t i = 0; i < half; i++) {
+        data1[i] = data2[i] = rand_fr();
+    }
+
+    TEST_CHECK(C_KZG_OK == das_fft_extension(data1, half, &fs1));
+    TEST_CHECK(C_KZG_OK == das_fft_extension(data2, half, &fs2));
+    for (uint64_t i = 0; i < half; i++) {
+        TEST_CHECK(fr_equal(data1 + i, data2 + i));
+    }
+
+    free_fft_settings(&fs1);
+    free_fft_settings(&fs2);
+}
+
+void das_extension_test_batch(void) {
+    FFTSettings fs;
+    const uint64_t count = 5;
+    // Enough work to be shared between threads: half * count is above DAS_EXTENSION_PARALLEL_MIN_LEN
+    TEST_CHECK(C_KZG_OK == new_fft_settings(&fs, 11));
+    uint64_t half = fs.max_width / 2, row = half + 3;
+
+    fr_t data[count][half], expected[count][half], interleaved[half * count], row_major[row * count];
+    for (uint64_t v = 0; v < count; v++) {
+        for (uint64_t i = 0; i < half; i++) {
+            data[v][i] = expected[v][i] = rand_fr();
+        }
+        TEST_CHECK(C_KZG_OK == das_fft_extension(expected[v], half, &fs));
+    }
+
+    // A count below one means one thread
+    for (int num_threads = 3; num_threads >= -1; num_threads -= 4) {
+        for (uint64_t v = 0; v < count; v++) {
+            for (uint64_t i = 0; i < half; i++) {
+                interleaved[i * count + v] = row_major[v * row + i] = data[v][i];
+            }
+        }
+        fs.num_threads = num_threads;
+        TEST_CHECK(C_KZG_OK == das_fft_extension_batch(interleaved, half, count, count, 1, &fs));
+        TEST_CHECK(C_KZG_OK == das_fft_extension_batch(row_major, half, count, 1, row, &fs));
+        for (uint64_t v = 0; v < count; v++) {
+            for (uint64_t i = 0; i < half; i++) {
+                TEST_CHECK(fr_equal(&expected[v][i], &interleaved[i * count + v]));
+                TEST_CHECK(fr_equal(&expected[v][i], &row_major[v * row + i]));
+            }
+        }
+    }
+
+    free_fft_settings(&fs);
+}
+
 TEST_LIST = {
     {"DAS_EXTENSION_TEST", title},
     {"das_extension_test_known", das_extension_test_known},
     {"das_extension_test_random", das_extension_test_random},
+    {"das_extension_test_stage_roots", das_extension_test_stage_roots},
+    {"das_extension_test_batch", das_extension_test_batch},
     {NULL, NULL} /* zero record marks the end of the list */
 };
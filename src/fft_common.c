@@ -22,6 +22,82 @@
 
 #include "fft_common.h"
 #include "c_kzg_util.h"
+#include "parallel.h"
+#include "utility.h"
+
+/**
+ * The smallest expansion of a root of unity that is spread over several threads.
+ *
+ * Below this, starting threads costs more than the multiplications.
+ */
+#define EXPAND_ROOT_PARALLEL_MIN_WIDTH 4096
+
+/** The shared state of the tasks making up one expansion of a root of unity. */
+typedef struct {
+    fr_t *out;        /**< Ascending powers of the root */
+    fr_t *reverse;    /**< Descending powers of the root, or `NULL` */
+    const fr_t *root; /**< The root of unity */
+    uint64_t half;    /**< Half the order of the root */
+} expand_root_job;
+
+static void expand_root_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    expand_root_job *job = ctx;
+    fr_t x;
+
+    // Jump straight to the first power of this range, then step through the rest
+    fr_pow(&x, job->root, start);
+    for (uint64_t i = start; i < end; i++) {
+        job->out[i] = x;
+        // root^-(half - i) = -root^i since root^half = -1
+        if (job->reverse != NULL) fr_negate(&job->reverse[job->half - i], &x);
+        fr_mul(&x, &x, job->root);
+    }
+}
+
+/**
+ * Generate powers of a root of unity, in ascending and optionally descending order, spread over several threads.
+ *
+ * Each thread starts its share of the powers from a power of the root calculated directly, so the serial chain of
+ * multiplications is only as long as the share. The order of the root is checked once at the end rather than at
+ * every step: for a power of two `width` above one it is exactly `width` if `root^(width / 2)` is minus one.
+ *
+ * The descending powers are only available for the first half, `root^0, ..., root^-(width / 2)`, as they are the
+ * negations of the ascending powers `root^(width / 2), ..., root^0`.
+ *
+ * @param[out] out         The generated powers of the root of unity (array size @p len)
+ * @param[out] reverse     The powers of the inverse of the root (array size `width / 2 + 1`), or `NULL`
+ * @param[in]  root        A root of unity
+ * @param[in]  width       The order of the root, a power of two
+ * @param[in]  len         The number of ascending powers to generate, between `width / 2 + 1` and @p width + 1, and
+ *                         exactly `width / 2 + 1` when @p reverse is given
+ * @param[in]  num_threads The number of threads to use for large expansions
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ */
+static C_KZG_RET expand_root_of_unity_parallel(fr_t *out, fr_t *reverse, const fr_t *root, uint64_t width,
+                                               uint64_t len, int num_threads) {
+    expand_root_job job = {.out = out, .reverse = reverse, .root = root, .half = width / 2};
+    fr_t minus_one;
+
+    CHECK(is_power_of_two(width));
+    if (width == 1) {
+        // There is no minus one among the powers, and the only one is its own inverse
+        CHECK(fr_is_one(root));
+        for (uint64_t i = 0; i < len; i++) {
+            out[i] = fr_one;
+        }
+        if (reverse != NULL) reverse[0] = fr_one;
+        return C_KZG_OK;
+    }
+
+    if (width < EXPAND_ROOT_PARALLEL_MIN_WIDTH) num_threads = 1;
+    parallel_for(expand_root_task, &job, len, num_threads);
+
+    fr_negate(&minus_one, &out[width / 2]);
+    CHECK(fr_is_one(&minus_one));
+
+    return C_KZG_OK;
+}
 
 /**
  * Generate powers of a root of unity in the field for use in the FFTs.
@@ -31,32 +107,26 @@
  *
  * @param[out] out   The generated powers of the root of unity (array size @p width + 1)
  * @param[in]  root  A root of unity
- * @param[in]  width One less than the size of @p out
+ * @param[in]  width One less than the size of @p out, a power of two
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  */
 C_KZG_RET expand_root_of_unity(fr_t *out, const fr_t *root, uint64_t width) {
-    out[0] = fr_one;
-    out[1] = *root;
-
-    for (uint64_t i = 2; !fr_is_one(&out[i - 1]); i++) {
-        CHECK(i <= width);
-        fr_mul(&out[i], &out[i - 1], root);
-    }
-    CHECK(fr_is_one(&out[width]));
-
-    return C_KZG_OK;
+    return expand_root_of_unity_parallel(out, NULL, root, width, width + 1, 1);
 }
 
 /**
  * Initialise an FFTSettings structure.
  *
- * Space is allocated for, and arrays are populated with, powers of the roots of unity. The two arrays contain the same
- * values in reverse order for convenience in inverse FFTs.
+ * Space is allocated for, and arrays are populated with, powers of the roots of unity. The two arrays hold the powers
+ * of the root of unity and of its inverse for convenience in inverse FFTs. Since `w^(max_width / 2)` is minus one,
+ * the arrays stop halfway and the rest of the powers are negations of these, see #fft_root_of_unity.
  *
  * `max_width` is the maximum size of FFT that can be calculated with these settings, and is a power of two by
  * construction. The same settings may be used to calculated FFTs of smaller power sizes.
  *
+ * Large FFTs are spread over `num_threads` threads, which is initially one and may be changed at any time.
+ *
  * @remark As with all functions prefixed `new_`, this allocates memory that needs to be reclaimed by calling the
  * corresponding `free_` function. In this case, #free_fft_settings.
  * @remark These settings may be used for FFTs on both field elements and G1 group elements.
@@ -69,22 +139,287 @@ C_KZG_RET expand_root_of_unity(fr_t *out, const fr_t *root, uint64_t width) {
  * @retval C_CZK_MALLOC  Memory allocation failed
  */
 C_KZG_RET new_fft_settings(FFTSettings *fs, unsigned int max_scale) {
+    return new_fft_settings_parallel(fs, max_scale, 1);
+}
+
+/**
+ * Initialise an FFTSettings structure, spreading the work over several threads.
+ *
+ * As #new_fft_settings, but the tables of roots of unity are filled by @p num_threads threads, which matters for
+ * large @p max_scale. Both tables are written in a single pass. The settings are then set to use the same number of
+ * threads for large FFTs.
+ *
+ * @remark The settings must be freed with #free_fft_settings.
+ *
+ * @param[out] fs          The new settings
+ * @param[in]  max_scale   Log base 2 of the max FFT size to be used with these settings
+ * @param[in]  num_threads The number of threads to use, with any value below one meaning one
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_ERROR   An internal error occurred
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET new_fft_settings_parallel(FFTSettings *fs, unsigned int max_scale, int num_threads) {
+    if (num_threads < 1) num_threads = 1;
     fs->max_width = (uint64_t)1 << max_scale;
 
     CHECK((max_scale < sizeof scale2_root_of_unity / sizeof scale2_root_of_unity[0]));
     fr_from_uint64s(&fs->root_of_unity, scale2_root_of_unity[max_scale]);
 
-    // Allocate space for the roots of unity
-    TRY(new_fr_array(&fs->expanded_roots_of_unity, fs->max_width + 1));
-    TRY(new_fr_array(&fs->reverse_roots_of_unity, fs->max_width + 1));
+    // Allocate space for the first half of the roots of unity
+    TRY(new_fr_array(&fs->expanded_roots_of_unity, fs->max_width / 2 + 1));
+    TRY(new_fr_array(&fs->reverse_roots_of_unity, fs->max_width / 2 + 1));
+
+    // Populate the roots of unity, both ways round
+    TRY(expand_root_of_unity_parallel(fs->expanded_roots_of_unity, fs->reverse_roots_of_unity, &fs->root_of_unity,
+                                      fs->max_width, fs->max_width / 2 + 1, num_threads));
 
-    // Populate the roots of unity
-    TRY(expand_root_of_unity(fs->expanded_roots_of_unity, &fs->root_of_unity, fs->max_width));
+    // The per-stage tables are optional, see #precompute_fft_settings
+    fs->stage_roots_of_unity = NULL;
+    fs->reverse_stage_roots_of_unity = NULL;
+    fs->num_threads = num_threads;
+
+    // The coset shift powers are optional, see #precompute_fft_coset
+    fs->coset_shift = fr_zero;
+    fs->coset_shift_powers = NULL;
+    fs->reverse_coset_shift_powers = NULL;
+
+    // The recoded roots are optional, see #precompute_fft_recodings
+    fs->recoded_roots_of_unity = NULL;
+
+    return C_KZG_OK;
+}
+
+/**
+ * Find a power of the root of unity of an FFTSettings structure, or of its inverse.
+ *
+ * The tables hold only the first half of the powers, and the rest are their negations since `w^(max_width / 2)` is
+ * minus one.
+ *
+ * @param[out] out     The power `w^i`, or `w^-i` if @p inverse is `true`, where `w` is `fs->root_of_unity`
+ * @param[in]  fs      The FFT settings
+ * @param[in]  inverse `false` for powers of the root of unity, `true` for powers of its inverse
+ * @param[in]  i       The exponent, which may be any value
+ */
+void fft_root_of_unity(fr_t *out, const FFTSettings *fs, bool inverse, uint64_t i) {
+    const fr_t *roots = inverse ? fs->reverse_roots_of_unity : fs->expanded_roots_of_unity;
+    uint64_t half = fs->max_width / 2;
+    i &= fs->max_width - 1;
+    if (i <= half) {
+        *out = roots[i];
+    } else {
+        fr_negate(out, &roots[i - half]);
+    }
+}
+
+/**
+ * Add per-stage tables of roots of unity to an FFTSettings structure.
+ *
+ * The butterflies of a stage that combines sub-transforms of size `h` use the powers `w^0, ..., w^(h-1)` of the
+ * `2h`th root of unity `w`. In the main tables these are spread out at a stride of `max_width / (2h)`, which is
+ * large for the early stages and costs a cache miss for nearly every read. The per-stage tables store them
+ * contiguously, one stage after another, so that each stage streams through its twiddles. The tables do not depend
+ * on the size of the transform. The last stage already has a stride of one in the main tables, so it is not copied,
+ * and the per-stage tables together take the same space as the two main tables.
+ *
+ * The FFT functions use the tables when present, via #fft_stage_roots.
+ *
+ * @remark The tables are freed by #free_fft_settings.
+ *
+ * @param[in,out] fs The settings, previously initialised with #new_fft_settings
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET precompute_fft_settings(FFTSettings *fs) {
+    if (fs->stage_roots_of_unity != NULL) return C_KZG_OK;
+
+    // There is nothing to copy for the smallest settings
+    if (fs->max_width <= 2) return C_KZG_OK;
+
+    TRY(new_fr_array(&fs->stage_roots_of_unity, fs->max_width / 2 - 1));
+    if (new_fr_array(&fs->reverse_stage_roots_of_unity, fs->max_width / 2 - 1) != C_KZG_OK) {
+        free(fs->stage_roots_of_unity);
+        fs->stage_roots_of_unity = NULL;
+        return C_KZG_MALLOC;
+    }
+
+    // Stage `h` starts at index `h - 1`
+    for (uint64_t h = 1; h < fs->max_width / 2; h *= 2) {
+        uint64_t stride = fs->max_width / (2 * h);
+        for (uint64_t k = 0; k < h; k++) {
+            fs->stage_roots_of_unity[h - 1 + k] = fs->expanded_roots_of_unity[k * stride];
+            fs->reverse_stage_roots_of_unity[h - 1 + k] = fs->reverse_roots_of_unity[k * stride];
+        }
+    }
+
+    return C_KZG_OK;
+}
+
+/**
+ * Find the twiddle factors for one stage of an FFT.
+ *
+ * Returns the powers of the `2h`th root of unity (or its inverse), which are `out[k * stride]` for `k` less than
+ * @p h. These come from the per-stage tables when #precompute_fft_settings has been run, and from the main tables
+ * otherwise. Only the first half of the main tables is ever needed, as `k * stride` is less than `max_width / 2`.
+ *
+ * @param[out] stride The stride of the returned twiddles
+ * @param[in]  fs     The FFT settings, with `max_width` at least `2 * h`
+ * @param[in]  inverse `false` for the forward transform, `true` for the inverse transform
+ * @param[in]  h      The size of the sub-transforms combined in this stage, a power of two
+ * @return The twiddle factors for the stage
+ */
+const fr_t *fft_stage_roots(uint64_t *stride, const FFTSettings *fs, bool inverse, uint64_t h) {
+    if (fs->stage_roots_of_unity != NULL && 2 * h < fs->max_width) {
+        *stride = 1;
+        return (inverse ? fs->reverse_stage_roots_of_unity : fs->stage_roots_of_unity) + h - 1;
+    }
+    *stride = fs->max_width / (2 * h);
+    return inverse ? fs->reverse_roots_of_unity : fs->expanded_roots_of_unity;
+}
+
+/**
+ * Add the roots of unity, recoded for multiplying G1 group elements, to an FFTSettings structure.
+ *
+ * Every twiddle factor of a G1 FFT is one of the roots of unity, and #g1_mul spends part of its time splitting and
+ * recoding the scalar before it starts on the group element. With the recodings cached here the G1 FFTs skip that
+ * work and go straight to #g1_mul_recoded, via #fft_stage_recodings. As with the main tables, the twiddles are all in
+ * the first half of the powers, so the table holds `w^0, ..., w^(max_width / 2 - 1)` followed by the same powers of
+ * the inverse.
+ *
+ * @remark The table is freed by #free_fft_settings. It takes a little over 256 bytes per root.
+ *
+ * @param[in,out] fs The settings, previously initialised with #new_fft_settings
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET precompute_fft_recodings(FFTSettings *fs) {
+    if (fs->recoded_roots_of_unity != NULL) return C_KZG_OK;
+
+    g1_mul_recoding_t *recoded;
+    uint64_t half = fs->max_width / 2;
+    // Keep one entry for the settings of width one, which have no twiddles
+    TRY(c_kzg_malloc((void **)&recoded, (half > 0 ? 2 * half : 1) * sizeof *recoded));
+    for (uint64_t i = 0; i < half; i++) {
+        g1_mul_recode(&recoded[i], &fs->expanded_roots_of_unity[i]);
+        g1_mul_recode(&recoded[half + i], &fs->reverse_roots_of_unity[i]);
+    }
+    fs->recoded_roots_of_unity = recoded;
+
+    return C_KZG_OK;
+}
+
+/**
+ * Find the recoded twiddle factors for one stage of a G1 FFT.
+ *
+ * As #fft_stage_roots, the recodings of the powers of the `2h`th root of unity (or its inverse) are `out[k * stride]`
+ * for `k` less than @p h.
+ *
+ * @param[out] stride The stride of the returned recodings
+ * @param[in]  fs     The FFT settings, with `max_width` at least `2 * h`
+ * @param[in]  inverse `false` for the forward transform, `true` for the inverse transform
+ * @param[in]  h      The size of the sub-transforms combined in this stage, a power of two
+ * @return The recoded twiddle factors for the stage, or `NULL` if #precompute_fft_recodings has not been run
+ */
+const g1_mul_recoding_t *fft_stage_recodings(uint64_t *stride, const FFTSettings *fs, bool inverse, uint64_t h) {
+    *stride = fs->max_width / (2 * h);
+    if (fs->recoded_roots_of_unity == NULL) return NULL;
+    return fs->recoded_roots_of_unity + (inverse ? fs->max_width / 2 : 0);
+}
+
+/**
+ * Fill an array with ascending powers of a field element, starting from one.
+ *
+ * @param[out] out The powers `x^0, ..., x^(n-1)` (array of length @p n)
+ * @param[in]  x   The field element
+ * @param[in]  n   The number of powers
+ */
+static void expand_powers(fr_t *out, const fr_t *x, uint64_t n) {
+    if (n == 0) return;
+    out[0] = fr_one;
+    for (uint64_t i = 1; i < n; i++) {
+        fr_mul(&out[i], &out[i - 1], x);
+    }
+}
+
+/**
+ * Cache the powers of a coset shift in an FFTSettings structure.
+ *
+ * The coset FFTs, such as #fft_fr_coset, multiply the `i`th coefficient by `shift^i` on the way in, or by
+ * `shift^-i` on the way out. When the shift matches the one cached here these powers are read from the tables rather
+ * than recalculated on every call. Any previously cached shift is replaced.
+ *
+ * @remark The tables are freed by #free_fft_settings.
+ *
+ * @param[in,out] fs    The settings, previously initialised with #new_fft_settings
+ * @param[in]     shift The coset shift, which must not be zero
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET precompute_fft_coset(FFTSettings *fs, const fr_t *shift) {
+    fr_t inv_shift;
+    CHECK(!fr_is_zero(shift));
+    if (fs->coset_shift_powers != NULL && fr_equal(shift, &fs->coset_shift)) return C_KZG_OK;
+
+    free(fs->coset_shift_powers);
+    free(fs->reverse_coset_shift_powers);
+    fs->coset_shift_powers = NULL;
+    fs->reverse_coset_shift_powers = NULL;
+
+    fr_t *powers, *reverse_powers;
+    TRY(new_fr_array(&powers, fs->max_width));
+    if (new_fr_array(&reverse_powers, fs->max_width) != C_KZG_OK) {
+        free(powers);
+        return C_KZG_MALLOC;
+    }
+
+    fr_inv(&inv_shift, shift);
+    expand_powers(powers, shift, fs->max_width);
+    expand_powers(reverse_powers, &inv_shift, fs->max_width);
+
+    fs->coset_shift = *shift;
+    fs->coset_shift_powers = powers;
+    fs->reverse_coset_shift_powers = reverse_powers;
+
+    return C_KZG_OK;
+}
+
+/**
+ * Find the powers of a coset shift for a coset FFT.
+ *
+ * Returns the cached table when @p shift is the one given to #precompute_fft_coset, and otherwise calculates the
+ * powers into a new array that the caller must free.
+ *
+ * @param[out] out     The powers `s^0, ..., s^(n-1)`, where `s` is @p shift, or its inverse if @p inverse is `true`
+ * @param[out] tmp     Memory to be freed by the caller after use, or `NULL` if none was allocated
+ * @param[in]  fs      The FFT settings, with `max_width` at least @p n
+ * @param[in]  shift   The coset shift, which must not be zero
+ * @param[in]  inverse `false` for powers of @p shift, `true` for powers of its inverse
+ * @param[in]  n       The number of powers needed
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET coset_shift_powers(const fr_t **out, fr_t **tmp, const FFTSettings *fs, const fr_t *shift, bool inverse,
+                             uint64_t n) {
+    fr_t x;
+    *tmp = NULL;
+    CHECK(!fr_is_zero(shift));
+    CHECK(n <= fs->max_width);
+
+    if (fs->coset_shift_powers != NULL && fr_equal(shift, &fs->coset_shift)) {
+        *out = inverse ? fs->reverse_coset_shift_powers : fs->coset_shift_powers;
+        return C_KZG_OK;
+    }
 
-    // Populate reverse roots of unity
-    for (uint64_t i = 0; i <= fs->max_width; i++) {
-        fs->reverse_roots_of_unity[i] = fs->expanded_roots_of_unity[fs->max_width - i];
+    TRY(new_fr_array(tmp, n));
+    if (inverse) {
+        fr_inv(&x, shift);
+    } else {
+        x = *shift;
     }
+    expand_powers(*tmp, &x, n);
+    *out = *tmp;
 
     return C_KZG_OK;
 }
@@ -97,5 +432,15 @@ C_KZG_RET new_fft_settings(FFTSettings *fs, unsigned int max_scale) {
 void free_fft_settings(FFTSettings *fs) {
     free(fs->expanded_roots_of_unity);
     free(fs->reverse_roots_of_unity);
+    free(fs->stage_roots_of_unity);
+    free(fs->reverse_stage_roots_of_unity);
+    free(fs->coset_shift_powers);
+    free(fs->reverse_coset_shift_powers);
+    free(fs->recoded_roots_of_unity);
+    fs->stage_roots_of_unity = NULL;
+    fs->reverse_stage_roots_of_unity = NULL;
+    fs->coset_shift_powers = NULL;
+    fs->reverse_coset_shift_powers = NULL;
+    fs->recoded_roots_of_unity = NULL;
     fs->max_width = 0;
 }
@@ -83,12 +83,28 @@ static const uint64_t scale2_root_of_unity[][4] = {
 typedef struct {
     uint64_t max_width;            /**< The maximum size of FFT these settings support, a power of 2. */
     fr_t root_of_unity;            /**< The root of unity used to generate the lists in the structure. */
-    fr_t *expanded_roots_of_unity; /**< Ascending powers of the root of unity, size `width + 1`. */
-    fr_t *reverse_roots_of_unity;  /**< Descending powers of the root of unity, size `width + 1`. */
+    fr_t *expanded_roots_of_unity; /**< Ascending powers of the root of unity, size `width / 2 + 1`. */
+    fr_t *reverse_roots_of_unity;  /**< Descending powers of the root of unity, size `width / 2 + 1`. */
+    fr_t *stage_roots_of_unity;    /**< Optional per-stage forward roots, size `width / 2 - 1`, or `NULL`. */
+    fr_t *reverse_stage_roots_of_unity; /**< Optional per-stage roots for the inverse FFTs, or `NULL`. */
+    int num_threads;               /**< The number of threads for large FFTs, default one, and below one means one. */
+    fr_t coset_shift;              /**< The coset shift for which powers are cached, if any. */
+    fr_t *coset_shift_powers;      /**< Optional ascending powers of `coset_shift`, size `width`, or `NULL`. */
+    fr_t *reverse_coset_shift_powers; /**< Optional ascending powers of the inverse of `coset_shift`, or `NULL`. */
+    g1_mul_recoding_t *recoded_roots_of_unity; /**< Optional recodings of the roots of both tables, size `width`. */
 } FFTSettings;
 
 C_KZG_RET expand_root_of_unity(fr_t *out, const fr_t *root, uint64_t width);
 C_KZG_RET new_fft_settings(FFTSettings *s, unsigned int max_scale);
+C_KZG_RET new_fft_settings_parallel(FFTSettings *fs, unsigned int max_scale, int num_threads);
+void fft_root_of_unity(fr_t *out, const FFTSettings *fs, bool inverse, uint64_t i);
+C_KZG_RET precompute_fft_settings(FFTSettings *fs);
+const fr_t *fft_stage_roots(uint64_t *stride, const FFTSettings *fs, bool inverse, uint64_t h);
+C_KZG_RET precompute_fft_recodings(FFTSettings *fs);
+const g1_mul_recoding_t *fft_stage_recodings(uint64_t *stride, const FFTSettings *fs, bool inverse, uint64_t h);
+C_KZG_RET precompute_fft_coset(FFTSettings *fs, const fr_t *shift);
+C_KZG_RET coset_shift_powers(const fr_t **out, fr_t **tmp, const FFTSettings *fs, const fr_t *shift, bool inverse,
+                             uint64_t n);
 void free_fft_settings(FFTSettings *s);
 
 #endif // FFT_COMMON
\ No newline at end of file
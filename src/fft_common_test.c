@@ -61,30 +61,147 @@ void expand_roots_is_plausible(void) {
     }
 }
 
+void expand_roots_checks_order(void) {
+    unsigned int scale = 6;
+    unsigned int width = 1 << scale;
+    fr_t root, expanded[width + 1];
+
+    // A root of too small an order, and a width that is not a power of two
+    fr_from_uint64s(&root, scale2_root_of_unity[scale - 1]);
+    TEST_CHECK(expand_root_of_unity(expanded, &root, width) == C_KZG_BADARGS);
+    fr_from_uint64s(&root, scale2_root_of_unity[scale]);
+    TEST_CHECK(expand_root_of_unity(expanded, &root, width - 1) == C_KZG_BADARGS);
+    TEST_CHECK(expand_root_of_unity(expanded, &root, width) == C_KZG_OK);
+}
+
+void parallel_fft_settings_match(void) {
+    unsigned int scale = 14;
+    FFTSettings s1, s2, s3;
+    TEST_CHECK(new_fft_settings(&s1, scale) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings_parallel(&s2, scale, 3) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings_parallel(&s3, scale, -1) == C_KZG_OK);
+    TEST_CHECK(s1.num_threads == 1);
+    TEST_CHECK(s2.num_threads == 3);
+    TEST_CHECK(s3.num_threads == 1);
+
+    for (uint64_t i = 0; i <= s1.max_width / 2; i++) {
+        TEST_CHECK(fr_equal(&s1.expanded_roots_of_unity[i], &s2.expanded_roots_of_unity[i]));
+        TEST_CHECK(fr_equal(&s1.reverse_roots_of_unity[i], &s2.reverse_roots_of_unity[i]));
+        TEST_CHECK(fr_equal(&s1.expanded_roots_of_unity[i], &s3.expanded_roots_of_unity[i]));
+        TEST_CHECK(fr_equal(&s1.reverse_roots_of_unity[i], &s3.reverse_roots_of_unity[i]));
+        TEST_MSG("Failed at %lu", i);
+    }
+
+    free_fft_settings(&s1);
+    free_fft_settings(&s2);
+    free_fft_settings(&s3);
+}
+
 void new_fft_settings_is_plausible(void) {
     // Just test one (largeish) value of scale
     int scale = 21;
     unsigned int width = 1 << scale;
-    fr_t prod;
+    fr_t x, y, prod;
     FFTSettings s;
 
     TEST_CHECK(new_fft_settings(&s, scale) == C_KZG_OK);
 
     // Verify - each pair should multiply to one
     for (unsigned int i = 1; i <= width; i++) {
-        fr_mul(&prod, s.expanded_roots_of_unity + i, s.reverse_roots_of_unity + i);
+        fft_root_of_unity(&x, &s, false, i);
+        fft_root_of_unity(&y, &s, true, i);
+        fr_mul(&prod, &x, &y);
         TEST_CHECK(true == fr_is_one(&prod));
     }
 
     free_fft_settings(&s);
 }
 
+void root_of_unity_matches_expansion(void) {
+    // Include the settings too small to have a minus one among their roots
+    for (unsigned int scale = 0; scale <= 6; scale++) {
+        FFTSettings fs;
+        uint64_t width = (uint64_t)1 << scale;
+        fr_t expanded[width + 1], x;
+        TEST_CHECK(new_fft_settings(&fs, scale) == C_KZG_OK);
+        TEST_CHECK(expand_root_of_unity(expanded, &fs.root_of_unity, width) == C_KZG_OK);
+
+        // Exponents beyond the width wrap around
+        for (uint64_t i = 0; i < 3 * width; i++) {
+            fft_root_of_unity(&x, &fs, false, i);
+            TEST_CHECK(fr_equal(&x, &expanded[i % width]));
+            fft_root_of_unity(&x, &fs, true, i);
+            TEST_CHECK(fr_equal(&x, &expanded[width - i % width]));
+            TEST_MSG("Failed at scale %u, exponent %lu", scale, i);
+        }
+
+        free_fft_settings(&fs);
+    }
+}
+
+void stage_roots_match_main_tables(void) {
+    unsigned int scale = 10;
+    FFTSettings s1, s2;
+    TEST_CHECK(new_fft_settings(&s1, scale) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings(&s2, scale) == C_KZG_OK);
+    TEST_CHECK(precompute_fft_settings(&s2) == C_KZG_OK);
+    TEST_CHECK(s1.stage_roots_of_unity == NULL);
+    TEST_CHECK(s2.stage_roots_of_unity != NULL);
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        for (uint64_t h = 1; h < s1.max_width; h *= 2) {
+            uint64_t stride1, stride2;
+            const fr_t *w1 = fft_stage_roots(&stride1, &s1, inverse, h);
+            const fr_t *w2 = fft_stage_roots(&stride2, &s2, inverse, h);
+            TEST_CHECK(stride2 == 1);
+            for (uint64_t k = 0; k < h; k++) {
+                TEST_CHECK(fr_equal(&w1[k * stride1], &w2[k * stride2]));
+            }
+        }
+    }
+
+    free_fft_settings(&s1);
+    free_fft_settings(&s2);
+}
+
+void stage_recodings_match_roots(void) {
+    unsigned int scale = 6;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, scale) == C_KZG_OK);
+    TEST_CHECK(fs.recoded_roots_of_unity == NULL);
+    TEST_CHECK(precompute_fft_recodings(&fs) == C_KZG_OK);
+    TEST_CHECK(fs.recoded_roots_of_unity != NULL);
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        for (uint64_t h = 1; h < fs.max_width; h *= 2) {
+            uint64_t stride, recoded_stride;
+            const fr_t *w = fft_stage_roots(&stride, &fs, inverse, h);
+            const g1_mul_recoding_t *r = fft_stage_recodings(&recoded_stride, &fs, inverse, h);
+            for (uint64_t k = 0; k < h; k++) {
+                g1_mul_recoding_t expected;
+                const g1_mul_recoding_t *got = &r[k * recoded_stride];
+                g1_mul_recode(&expected, &w[k * stride]);
+                TEST_CHECK(expected.len1 == got->len1 && expected.len2 == got->len2);
+                TEST_CHECK(memcmp(expected.d1, got->d1, expected.len1) == 0);
+                TEST_CHECK(memcmp(expected.d2, got->d2, expected.len2) == 0);
+            }
+        }
+    }
+
+    free_fft_settings(&fs);
+}
+
 TEST_LIST = {
     {"FFT_COMMON_TEST", title},
     {"roots_of_unity_is_the_expected_size", roots_of_unity_is_the_expected_size},
     {"roots_of_unity_out_of_bounds_fails", roots_of_unity_out_of_bounds_fails},
     {"roots_of_unity_are_plausible", roots_of_unity_are_plausible},
     {"expand_roots_is_plausible", expand_roots_is_plausible},
+    {"expand_roots_checks_order", expand_roots_checks_order},
+    {"parallel_fft_settings_match", parallel_fft_settings_match},
     {"new_fft_settings_is_plausible", new_fft_settings_is_plausible},
+    {"root_of_unity_matches_expansion", root_of_unity_matches_expansion},
+    {"stage_roots_match_main_tables", stage_roots_match_main_tables},
+    {"stage_recodings_match_roots", stage_recodings_match_roots},
     {NULL, NULL} /* zero record marks the end of the list */
 };
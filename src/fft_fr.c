@@ -27,6 +27,7 @@
 
 #include "fft_fr.h"
 #include "c_kzg_util.h"
+#include "parallel.h"
 #include "utility.h"
 
 /**
@@ -63,7 +64,7 @@ void fft_fr_slow(fr_t *out, const fr_t *in, uint64_t stride, const fr_t *roots,
  * @param[out] out    The results (array of length @p n)
  * @param[in]  in     The input data (array of length @p n * @p stride)
  * @param[in]  stride The input data stride
- * @param[in]  roots  Roots of unity (array of length @p n * @p roots_stride)
+ * @param[in]  roots  Roots of unity (array of length @p n / 2 * @p roots_stride)
  * @param[in]  roots_stride The stride interval among the roots of unity
  * @param[in]  n      Length of the FFT, must be a power of two
  */
@@ -83,6 +84,963 @@ void fft_fr_fast(fr_t *out, const fr_t *in, uint64_t stride, const fr_t *roots,
     }
 }
 
+/**
+ * Number of elements processed together in the first passes of fft_fr_inplace().
+ *
+ * All stages of sub-transforms up to this size are completed one block at a time, so that each block stays in cache
+ * between passes. 1024 elements is 32KB, which fits comfortably in L2 and mostly in L1.
+ */
+#define FFT_FR_BLOCK_SIZE 1024
+
+/**
+ * The smallest FFT that fft_fr_inplace() spreads over several threads.
+ *
+ * Below this, starting threads costs more than the transform.
+ */
+#define FFT_FR_PARALLEL_MIN_LEN 4096
+
+/**
+ * The most butterflies of a radix-4 pass given to the array kernels at once.
+ *
+ * Both stages of the pass are done on a chunk before moving on, so the chunk's 256 elements should stay in L1.
+ */
+#define FFT_FR_VEC_CHUNK 64
+
+/**
+ * A single radix-2 decimation-in-time butterfly.
+ *
+ * @param[in,out] a The first element
+ * @param[in,out] b The second element
+ * @param[in]     w The twiddle factor, or `NULL` if it is one
+ */
+static inline void fft_fr_radix2_butterfly(fr_t *a, fr_t *b, const fr_t *w) {
+    fr_t y_times_root;
+    if (w == NULL) {
+        y_times_root = *b;
+    } else {
+        fr_mul(&y_times_root, b, w);
+    }
+    fr_sub(b, a, &y_times_root);
+    fr_add(a, a, &y_times_root);
+}
+
+/**
+ * A single radix-4 decimation-in-time butterfly, doing the work of two stages of radix-2 butterflies.
+ *
+ * @param[in,out] a  The first element
+ * @param[in,out] b  The second element
+ * @param[in,out] c  The third element
+ * @param[in,out] d  The fourth element
+ * @param[in]     w1 The twiddle factor of the first stage, or `NULL` if it is one
+ * @param[in]     w2 The twiddle factor of the second stage for @p a and @p c, or `NULL` if it is one
+ * @param[in]     w3 The twiddle factor of the second stage for @p b and @p d
+ */
+static inline void fft_fr_radix4_butterfly(fr_t *a, fr_t *b, fr_t *c, fr_t *d, const fr_t *w1, const fr_t *w2,
+                                           const fr_t *w3) {
+    fr_t a1, b1, c1, d1, t;
+
+    // First stage: (a, b) and (c, d) with the same twiddle
+    if (w1 == NULL) {
+        fr_add(&a1, a, b);
+        fr_sub(&b1, a, b);
+        fr_add(&c1, c, d);
+        fr_sub(&d1, c, d);
+    } else {
+        fr_mul(&t, b, w1);
+        fr_add(&a1, a, &t);
+        fr_sub(&b1, a, &t);
+        fr_mul(&t, d, w1);
+        fr_add(&c1, c, &t);
+        fr_sub(&d1, c, &t);
+    }
+
+    // Second stage: (a1, c1) with the twiddle for k and (b1, d1) with the twiddle for k + h
+    if (w2 == NULL) {
+        t = c1;
+    } else {
+        fr_mul(&t, &c1, w2);
+    }
+    fr_add(a, &a1, &t);
+    fr_sub(c, &a1, &t);
+    fr_mul(&t, &d1, w3);
+    fr_add(b, &b1, &t);
+    fr_sub(d, &b1, &t);
+}
+
+/**
+ * The largest FFT done entirely by one of the unrolled kernels of fft_fr_small().
+ *
+ * Larger transforms start with the kernel for this size on each block of their input, in place of the first few
+ * passes.
+ */
+#define FFT_FR_SMALL_MAX 16
+
+/**
+ * One butterfly of the unrolled kernels.
+ *
+ * Combines the sub-transforms of size `H` at offset `J`, at position `K` within them. The twiddle factor is read from
+ * the table @p w of the powers of the `2M`th root of unity at stride @p ws, and is skipped when `K` is zero. All but
+ * @p x, @p w and @p ws are constants, so the indexing folds away when the macros are expanded.
+ */
+#define FFT_FR_SMALL_BFLY(x, w, ws, M, H, J, K)                                                                       \
+    fft_fr_radix2_butterfly(&(x)[(J) + (K)], &(x)[(J) + (K) + (H)], (K) == 0 ? NULL : &(w)[(K) * ((M) / (H)) * (ws)])
+#define FFT_FR_SMALL_BFLY_2(x, w, ws, M, H, J, K)                                                                     \
+    do {                                                                                                               \
+        FFT_FR_SMALL_BFLY(x, w, ws, M, H, J, K);                                                                       \
+        FFT_FR_SMALL_BFLY(x, w, ws, M, H, J, (K) + 1);                                                                 \
+    } while (0)
+#define FFT_FR_SMALL_BFLY_4(x, w, ws, M, H, J, K)                                                                     \
+    do {                                                                                                               \
+        FFT_FR_SMALL_BFLY_2(x, w, ws, M, H, J, K);                                                                     \
+        FFT_FR_SMALL_BFLY_2(x, w, ws, M, H, J, (K) + 2);                                                               \
+    } while (0)
+#define FFT_FR_SMALL_BFLY_8(x, w, ws, M, H, J, K)                                                                     \
+    do {                                                                                                               \
+        FFT_FR_SMALL_BFLY_4(x, w, ws, M, H, J, K);                                                                     \
+        FFT_FR_SMALL_BFLY_4(x, w, ws, M, H, J, (K) + 4);                                                               \
+    } while (0)
+
+/**
+ * Unrolled decimation-in-time FFTs of the sizes up to #FFT_FR_SMALL_MAX, at offset `J` of @p x.
+ *
+ * Each is two of the next size down followed by the stage that combines them, depth first, so that the elements are
+ * reused while they are still in registers or L1.
+ */
+#define FFT_FR_SMALL_2(x, w, ws, M, J) FFT_FR_SMALL_BFLY(x, w, ws, M, 1, J, 0)
+#define FFT_FR_SMALL_4(x, w, ws, M, J)                                                                                \
+    do {                                                                                                               \
+        FFT_FR_SMALL_2(x, w, ws, M, J);                                                                                \
+        FFT_FR_SMALL_2(x, w, ws, M, (J) + 2);                                                                          \
+        FFT_FR_SMALL_BFLY_2(x, w, ws, M, 2, J, 0);                                                                     \
+    } while (0)
+#define FFT_FR_SMALL_8(x, w, ws, M, J)                                                                                \
+    do {                                                                                                               \
+        FFT_FR_SMALL_4(x, w, ws, M, J);                                                                                \
+        FFT_FR_SMALL_4(x, w, ws, M, (J) + 4);                                                                          \
+        FFT_FR_SMALL_BFLY_4(x, w, ws, M, 4, J, 0);                                                                     \
+    } while (0)
+#define FFT_FR_SMALL_16(x, w, ws, M, J)                                                                               \
+    do {                                                                                                               \
+        FFT_FR_SMALL_8(x, w, ws, M, J);                                                                                \
+        FFT_FR_SMALL_8(x, w, ws, M, (J) + 8);                                                                          \
+        FFT_FR_SMALL_BFLY_8(x, w, ws, M, 8, J, 0);                                                                     \
+    } while (0)
+
+/**
+ * Fast Fourier Transform of a small size, fully unrolled.
+ *
+ * Does all the stages of a decimation-in-time transform of size @p n, up to #FFT_FR_SMALL_MAX, with no loops or
+ * runtime index arithmetic.
+ *
+ * @param[in,out] x  The data, in bit-reversed order (array of length @p n)
+ * @param[in]     n  The length of the FFT, a power of two no more than #FFT_FR_SMALL_MAX
+ * @param[in]     w  Twiddle factors for the last stage, as returned by #fft_stage_roots for `n / 2`
+ * @param[in]     ws The stride of @p w
+ */
+static void fft_fr_small(fr_t *x, uint64_t n, const fr_t *w, uint64_t ws) {
+    switch (n) {
+    case 2:
+        FFT_FR_SMALL_2(x, w, ws, 1, 0);
+        break;
+    case 4:
+        FFT_FR_SMALL_4(x, w, ws, 2, 0);
+        break;
+    case 8:
+        FFT_FR_SMALL_8(x, w, ws, 4, 0);
+        break;
+    case 16:
+        FFT_FR_SMALL_16(x, w, ws, 8, 0);
+        break;
+    }
+}
+
+/**
+ * Radix-2 decimation-in-time butterflies.
+ *
+ * Part of a pass combining pairs of sub-transforms of size @p h into sub-transforms of size `2 * h`, using the array
+ * kernels such as #fr_vec_butterfly. A whole pass over `len` elements is butterflies `0` to `len / 2`, and any range
+ * of them may be done independently.
+ *
+ * @param[in,out] x     The data
+ * @param[in]     h     The size of the sub-transforms being combined
+ * @param[in]     w     Twiddle factors for the stage, as returned by #fft_stage_roots
+ * @param[in]     ws    The stride of @p w
+ * @param[in]     post  Factors to multiply the outputs by, indexed by position, or `NULL`
+ * @param[in]     start The first butterfly to do
+ * @param[in]     end   One past the last butterfly to do
+ */
+static void fft_fr_radix2_pass(fr_t *x, uint64_t h, const fr_t *w, uint64_t ws, const fr_t *post, uint64_t start,
+                               uint64_t end) {
+    uint64_t i = start;
+    while (i < end) {
+        uint64_t k = i & (h - 1), j = (i - k) * 2, len = h - k < end - i ? h - k : end - i;
+        fr_t *a = &x[j + k], *b = &x[j + k + h];
+        if (k == 0) {
+            // The first twiddle of each block is one
+            fft_fr_radix2_butterfly(a, b, NULL);
+            fr_vec_butterfly(a + 1, b + 1, &w[ws], ws, len - 1);
+        } else {
+            fr_vec_butterfly(a, b, &w[k * ws], ws, len);
+        }
+        if (post != NULL) {
+            fr_vec_mul(a, a, &post[j + k], len);
+            fr_vec_mul(b, b, &post[j + k + h], len);
+        }
+        i += len;
+    }
+}
+
+/**
+ * Radix-4 decimation-in-time butterflies.
+ *
+ * Does the work of two radix-2 passes, combining groups of four sub-transforms of size @p h into sub-transforms of
+ * size `4 * h`, with one read and one write of each element from memory. The butterflies are done in chunks of
+ * #FFT_FR_VEC_CHUNK with the array kernels, both stages of a chunk in turn. A whole pass over `len` elements is
+ * butterflies `0` to `len / 4`, and any range of them may be done independently.
+ *
+ * @param[in,out] x     The data
+ * @param[in]     h     The size of the sub-transforms being combined
+ * @param[in]     w1    Twiddle factors for the stage of size @p h, as returned by #fft_stage_roots
+ * @param[in]     ws1   The stride of @p w1
+ * @param[in]     w2    Twiddle factors for the stage of size `2 * h`
+ * @param[in]     ws2   The stride of @p w2
+ * @param[in]     post  Factors to multiply the outputs by, indexed by position, or `NULL`
+ * @param[in]     start The first butterfly to do
+ * @param[in]     end   One past the last butterfly to do
+ */
+static void fft_fr_radix4_pass(fr_t *x, uint64_t h, const fr_t *w1, uint64_t ws1, const fr_t *w2, uint64_t ws2,
+                               const fr_t *post, uint64_t start, uint64_t end) {
+    uint64_t i = start;
+    while (i < end) {
+        uint64_t k = i & (h - 1), j = (i - k) * 4, len = h - k < end - i ? h - k : end - i, m = 0;
+        if (len > FFT_FR_VEC_CHUNK) len = FFT_FR_VEC_CHUNK;
+        fr_t *a = &x[j + k], *b = &x[j + k + h], *c = &x[j + k + 2 * h], *d = &x[j + k + 3 * h];
+        if (k == 0) {
+            fft_fr_radix4_butterfly(a, b, c, d, NULL, NULL, &w2[h * ws2]);
+            m = 1;
+        }
+        if (len > m) {
+            // The two stages, one after the other on the chunk while it is in L1
+            fr_vec_butterfly(a + m, b + m, &w1[(k + m) * ws1], ws1, len - m);
+            fr_vec_butterfly(c + m, d + m, &w1[(k + m) * ws1], ws1, len - m);
+            fr_vec_butterfly(a + m, c + m, &w2[(k + m) * ws2], ws2, len - m);
+            fr_vec_butterfly(b + m, d + m, &w2[(k + m + h) * ws2], ws2, len - m);
+        }
+        if (post != NULL) {
+            fr_vec_mul(a, a, &post[j + k], len);
+            fr_vec_mul(b, b, &post[j + k + h], len);
+            fr_vec_mul(c, c, &post[j + k + 2 * h], len);
+            fr_vec_mul(d, d, &post[j + k + 3 * h], len);
+        }
+        i += len;
+    }
+}
+
+/** The shared state of the tasks making up one fft_fr_inplace(). */
+typedef struct {
+    fr_t *x;                /**< The data */
+    const fr_t *in;         /**< The input data, which may be the same as @p x */
+    uint64_t n;             /**< The length of the data */
+    uint64_t in_len;        /**< The number of inputs that may be non-zero, for the pruned transforms */
+    uint64_t h;             /**< The size of the sub-transforms being combined in the current pass */
+    uint64_t block;         /**< The size of the sub-transforms done by each task, or of the outputs kept */
+    bool bit_reversed;      /**< `true` if the input is already in bit-reversed order */
+    bool inverse;           /**< `true` for the inverse transform */
+    const FFTSettings *fs;  /**< The FFT settings */
+    const fr_t *w1, *w2;    /**< Twiddle factors for the stages of the current pass */
+    uint64_t ws1, ws2;      /**< Strides of the twiddle factors */
+    const fr_t *pre;        /**< Factors to multiply the inputs by, indexed by position, or `NULL` */
+    const fr_t *factor;     /**< A factor to multiply all the inputs by, or `NULL` */
+    const fr_t *post;       /**< Factors to multiply the outputs of the current pass by, or `NULL` */
+} fft_fr_job;
+
+static void fft_fr_radix2_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    fft_fr_radix2_pass(job->x, job->h, job->w1, job->ws1, job->post, start, end);
+}
+
+static void fft_fr_radix4_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    fft_fr_radix4_pass(job->x, job->h, job->w1, job->ws1, job->w2, job->ws2, job->post, start, end);
+}
+
+static void fft_fr_small_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        fft_fr_small(job->x + i * FFT_FR_SMALL_MAX, FFT_FR_SMALL_MAX, job->w1, job->ws1);
+    }
+}
+
+/**
+ * Run the decimation-in-time passes for sub-transforms from size @p h up to size @p len.
+ *
+ * Starting from scratch, the first stages are done by the unrolled kernels of #fft_fr_small, which cover the whole
+ * transform when it is small. The rest use radix-4 passes, preceded by a single radix-2 pass if the number of stages
+ * is odd. Each pass is shared between @p num_threads threads. The outputs of the last pass are multiplied by @p post,
+ * if given.
+ *
+ * @param[in,out] x           The data, in bit-reversed order relative to the final sub-transforms
+ * @param[in]     len         The size of the sub-transforms to finish with, a power of two
+ * @param[in]     h           The size of the sub-transforms already completed, a power of two
+ * @param[in]     inverse     `false` for forward transform, `true` for inverse transform
+ * @param[in]     fs          The FFT settings, with `max_width` at least @p len
+ * @param[in]     num_threads The number of threads to use
+ * @param[in]     post        Factors to multiply the final outputs by (array of length @p len), or `NULL`
+ */
+static void fft_fr_passes(fr_t *x, uint64_t len, uint64_t h, bool inverse, const FFTSettings *fs, int num_threads,
+                          const fr_t *post) {
+    fft_fr_job job = {.x = x, .n = len, .inverse = inverse, .fs = fs};
+    if (h == 1 && len > 1 && len <= FFT_FR_SMALL_MAX) {
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, len / 2);
+        fft_fr_small(x, len, job.w1, job.ws1);
+        if (post != NULL) fr_vec_mul(x, x, post, len);
+        return;
+    }
+    if (h == 1 && len > FFT_FR_SMALL_MAX) {
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, FFT_FR_SMALL_MAX / 2);
+        parallel_for(fft_fr_small_task, &job, len / FFT_FR_SMALL_MAX, num_threads);
+        h = FFT_FR_SMALL_MAX;
+    }
+    if (h < len && log2_pow2(len / h) % 2) {
+        job.h = h;
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, h);
+        job.post = 2 * h == len ? post : NULL;
+        parallel_for(fft_fr_radix2_task, &job, len / 2, num_threads);
+        h *= 2;
+    }
+    for (; h < len; h *= 4) {
+        job.h = h;
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, h);
+        job.w2 = fft_stage_roots(&job.ws2, fs, inverse, 2 * h);
+        job.post = 4 * h == len ? post : NULL;
+        parallel_for(fft_fr_radix4_task, &job, len / 4, num_threads);
+    }
+}
+
+/**
+ * Copy one input element into place, applying any input factors.
+ *
+ * @param[out] out The destination, which may be the same as @p in
+ * @param[in]  in  The input element
+ * @param[in]  i   The position of the input element
+ * @param[in]  job The transform, giving the input factors
+ */
+static void fft_fr_load(fr_t *out, const fr_t *in, uint64_t i, const fft_fr_job *job) {
+    if (job->pre != NULL) {
+        fr_mul(out, in, &job->pre[i]);
+    } else {
+        *out = *in;
+    }
+    if (job->factor != NULL) {
+        fr_mul(out, out, job->factor);
+    }
+}
+
+static void fft_fr_bit_reverse_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    int unused_bit_len = 32 - log2_pow2(job->n);
+    bool scaled = job->pre != NULL || job->factor != NULL;
+    for (uint64_t i = start; i < end; i++) {
+        uint64_t r = reverse_bits(i) >> unused_bit_len;
+        if (job->in != job->x) {
+            fft_fr_load(&job->x[r], &job->in[i], i, job);
+        } else if (r > i) {
+            fr_t tmp;
+            fft_fr_load(&tmp, &job->x[i], i, job);
+            fft_fr_load(&job->x[i], &job->x[r], r, job);
+            job->x[r] = tmp;
+        } else if (r == i && scaled) {
+            fft_fr_load(&job->x[i], &job->x[i], i, job);
+        }
+    }
+}
+
+static void fft_fr_block_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        fft_fr_passes(job->x + i * job->block, job->block, job->h, job->inverse, job->fs, 1, NULL);
+    }
+}
+
+/**
+ * The layout of a batch of vectors transformed together by fft_fr_batch().
+ *
+ * Element `i` of vector `v` is at `x[i * elem_stride + v * vec_stride]`.
+ */
+typedef struct {
+    fr_t *x;              /**< The data */
+    uint64_t n;           /**< The length of each vector */
+    uint64_t count;       /**< The number of vectors */
+    uint64_t elem_stride; /**< The distance between consecutive elements of a vector */
+    uint64_t vec_stride;  /**< The distance between the starts of consecutive vectors */
+    bool inverse;         /**< `true` for the inverse transform */
+    const FFTSettings *fs; /**< The FFT settings */
+    const fr_t *factor;   /**< A factor to multiply all the inputs by, or `NULL` */
+} fft_fr_batch_job;
+
+/**
+ * Permute every vector of a batch into bit-reversed order, applying any input factor.
+ *
+ * @param[in] job The batch
+ */
+static void fft_fr_batch_bit_reverse(const fft_fr_batch_job *job) {
+    int unused_bit_len = 32 - log2_pow2(job->n);
+    for (uint64_t i = 0; i < job->n; i++) {
+        uint64_t r = reverse_bits(i) >> unused_bit_len;
+        fr_t *a = job->x + i * job->elem_stride, *b = job->x + r * job->elem_stride;
+        if (r > i) {
+            for (uint64_t v = 0; v < job->count; v++) {
+                fr_t tmp = a[v * job->vec_stride];
+                a[v * job->vec_stride] = b[v * job->vec_stride];
+                b[v * job->vec_stride] = tmp;
+            }
+        }
+        if (r >= i && job->factor != NULL) {
+            for (uint64_t v = 0; v < job->count; v++) {
+                fr_mul(&a[v * job->vec_stride], &a[v * job->vec_stride], job->factor);
+                if (r > i) fr_mul(&b[v * job->vec_stride], &b[v * job->vec_stride], job->factor);
+            }
+        }
+    }
+}
+
+/**
+ * Run the decimation-in-time passes on every vector of a batch, for sub-transforms from size @p h up to size @p len.
+ *
+ * As #fft_fr_passes, but each twiddle factor is loaded once and applied to the same butterfly of all the vectors. For
+ * interleaved vectors this uses the array kernels such as #fr_vec_butterfly.
+ *
+ * @param[in] job The batch, with @p job->x pointing to the first element of the sub-transforms
+ * @param[in] len The size of the sub-transforms to finish with, a power of two
+ * @param[in] h   The size of the sub-transforms already completed, a power of two
+ */
+static void fft_fr_batch_passes(const fft_fr_batch_job *job, uint64_t len, uint64_t h) {
+    uint64_t es = job->elem_stride, vs = job->vec_stride;
+    if (h < len && log2_pow2(len / h) % 2) {
+        uint64_t ws;
+        const fr_t *w = fft_stage_roots(&ws, job->fs, job->inverse, h);
+        for (uint64_t i = 0; i < len / 2; i++) {
+            uint64_t k = i & (h - 1), j = (i - k) * 2;
+            const fr_t *wk = k == 0 ? NULL : &w[k * ws];
+            fr_t *a = job->x + (j + k) * es, *b = job->x + (j + k + h) * es;
+            if (vs == 1 && wk != NULL) {
+                fr_vec_butterfly(a, b, wk, 0, job->count);
+                continue;
+            }
+            for (uint64_t v = 0; v < job->count; v++) {
+                fft_fr_radix2_butterfly(&a[v * vs], &b[v * vs], wk);
+            }
+        }
+        h *= 2;
+    }
+    for (; h < len; h *= 4) {
+        uint64_t ws1, ws2;
+        const fr_t *w1 = fft_stage_roots(&ws1, job->fs, job->inverse, h);
+        const fr_t *w2 = fft_stage_roots(&ws2, job->fs, job->inverse, 2 * h);
+        for (uint64_t i = 0; i < len / 4; i++) {
+            uint64_t k = i & (h - 1), j = (i - k) * 4;
+            const fr_t *w1k = k == 0 ? NULL : &w1[k * ws1], *w2k = k == 0 ? NULL : &w2[k * ws2];
+            const fr_t *w3k = &w2[(k + h) * ws2];
+            fr_t *a = job->x + (j + k) * es, *b = job->x + (j + k + h) * es;
+            fr_t *c = job->x + (j + k + 2 * h) * es, *d = job->x + (j + k + 3 * h) * es;
+            if (vs == 1 && k != 0) {
+                fr_vec_butterfly(a, b, w1k, 0, job->count);
+                fr_vec_butterfly(c, d, w1k, 0, job->count);
+                fr_vec_butterfly(a, c, w2k, 0, job->count);
+                fr_vec_butterfly(b, d, w3k, 0, job->count);
+                continue;
+            }
+            for (uint64_t v = 0; v < job->count; v++) {
+                fft_fr_radix4_butterfly(&a[v * vs], &b[v * vs], &c[v * vs], &d[v * vs], w1k, w2k, w3k);
+            }
+        }
+    }
+}
+
+/**
+ * Transform a batch of vectors on a single thread.
+ *
+ * The early passes are done a block of positions at a time, sized so that the block holds about
+ * #FFT_FR_BLOCK_SIZE elements across all the vectors.
+ *
+ * @param[in] job The batch
+ */
+static void fft_fr_batch_serial(const fft_fr_batch_job *job) {
+    uint64_t block = job->count < FFT_FR_BLOCK_SIZE ? FFT_FR_BLOCK_SIZE / next_power_of_two(job->count) : 1;
+
+    fft_fr_batch_bit_reverse(job);
+    if (job->n <= block || block < 2) {
+        fft_fr_batch_passes(job, job->n, 1);
+        return;
+    }
+    for (uint64_t i = 0; i < job->n; i += block) {
+        fft_fr_batch_job sub = *job;
+        sub.x = job->x + i * job->elem_stride;
+        fft_fr_batch_passes(&sub, block, 1);
+    }
+    fft_fr_batch_passes(job, job->n, block);
+}
+
+static void fft_fr_batch_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_batch_job sub = *(fft_fr_batch_job *)ctx;
+    sub.x += start * sub.vec_stride;
+    sub.count = end - start;
+    fft_fr_batch_serial(&sub);
+}
+
+/**
+ * Run all the decimation-in-time passes of a transform whose data is in bit-reversed order.
+ *
+ * The early passes are run one cache-sized block at a time, and the later ones are each shared between the threads.
+ *
+ * @param[in,out] job         The transform, with @p job->x in bit-reversed order
+ * @param[in]     post        Factors to multiply the outputs by (array of length `job->n`), or `NULL`
+ * @param[in]     num_threads The number of threads to use
+ */
+static void fft_fr_dit_passes(fft_fr_job *job, const fr_t *post, int num_threads) {
+    if (job->n <= FFT_FR_BLOCK_SIZE) {
+        fft_fr_passes(job->x, job->n, 1, job->inverse, job->fs, 1, post);
+        return;
+    }
+    job->h = 1;
+    job->block = FFT_FR_BLOCK_SIZE;
+    parallel_for(fft_fr_block_task, job, job->n / FFT_FR_BLOCK_SIZE, num_threads);
+    fft_fr_passes(job->x, job->n, FFT_FR_BLOCK_SIZE, job->inverse, job->fs, num_threads, post);
+}
+
+/**
+ * Fast Fourier Transform, with optional scaling of the inputs and outputs, for sizes that fit in cache.
+ *
+ * Iterative, with radix-4 butterflies. The input is permuted into bit-reversed order, then sub-transforms are
+ * combined pass by pass. The early passes are run one cache-sized block at a time.
+ *
+ * Large transforms are spread over @p num_threads threads. The blocks are independent, and the butterflies of
+ * each later pass are shared out between the threads.
+ *
+ * The input factors are applied as the input is permuted, and the output factors in the last pass, so that neither
+ * costs an extra pass over the data.
+ *
+ * @remark The inverse transform is not scaled by `1 / n`, except through @p factor.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n), which may be the same as @p out
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  pre     Factors to multiply the inputs by (array of length @p n), or `NULL`
+ * @param[in]  factor  A factor to multiply all the inputs by, or `NULL`
+ * @param[in]  post    Factors to multiply the outputs by (array of length @p n), or `NULL`
+ * @param[in]  num_threads The number of threads to use for large transforms
+ */
+static void fft_fr_iterative(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs,
+                             const fr_t *pre, const fr_t *factor, const fr_t *post, int num_threads) {
+    fft_fr_job job = {.x = out, .in = in, .n = n, .inverse = inverse, .fs = fs, .pre = pre, .factor = factor};
+    if (n < FFT_FR_PARALLEL_MIN_LEN) num_threads = 1;
+
+    if (n == 0) return;
+    if (n == 1) {
+        fft_fr_load(out, in, 0, &job);
+        if (post != NULL) fr_mul(out, out, &post[0]);
+        return;
+    }
+
+    parallel_for(fft_fr_bit_reverse_task, &job, n, num_threads);
+    fft_fr_dit_passes(&job, post, num_threads);
+}
+
+/**
+ * The smallest FFT that fft_fr() does with the four-step method of fft_fr_four_step().
+ *
+ * Below this the whole transform fits comfortably in cache, and the iterative method is faster.
+ */
+#define FFT_FR_FOUR_STEP_MIN_LEN (1 << 18)
+
+/**
+ * The number of columns transformed together in the first step of fft_fr_four_step().
+ *
+ * Each row of a tile is then 16 field elements, or 512 bytes, and a tile of 512 rows fits in L2.
+ */
+#define FFT_FR_FOUR_STEP_TILE 16
+
+/**
+ * The shared state of the tasks making up one fft_fr_four_step().
+ *
+ * The data is viewed as a matrix of @p n1 rows by @p n2 columns, in row-major order.
+ */
+typedef struct {
+    fr_t *x;               /**< The working matrix */
+    fr_t *out;             /**< The results */
+    const fr_t *in;        /**< The input data */
+    uint64_t n, n1, n2;    /**< The length of the data, and the number of rows and columns */
+    uint64_t tile;         /**< The number of columns in each tile of the first step */
+    bool inverse;          /**< `true` for the inverse transform */
+    const FFTSettings *fs; /**< The FFT settings */
+    fft_fr_job load;       /**< The input factors, see fft_fr_load() */
+    const fr_t *post;      /**< Factors to multiply the outputs by, or `NULL` */
+} fft_fr_four_step_job;
+
+static void fft_fr_four_step_load_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_four_step_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        fft_fr_load(&job->x[i], &job->in[i], i, &job->load);
+    }
+}
+
+static void fft_fr_four_step_column_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_four_step_job *job = ctx;
+    uint64_t roots_stride = job->fs->max_width / job->n;
+
+    for (uint64_t t = start; t < end; t++) {
+        uint64_t c0 = t * job->tile;
+        fft_fr_batch_job batch = {.x = job->x + c0,
+                                  .n = job->n1,
+                                  .count = job->tile,
+                                  .elem_stride = job->n2,
+                                  .vec_stride = 1,
+                                  .inverse = job->inverse,
+                                  .fs = job->fs};
+        if (job->n1 > 1) fft_fr_batch_serial(&batch);
+
+        // Multiply element (k1, j2) by w^(k1 * j2) while the tile is still in cache
+        for (uint64_t k1 = 1; k1 < job->n1; k1++) {
+            fr_t w, step;
+            fft_root_of_unity(&w, job->fs, job->inverse, k1 * c0 * roots_stride);
+            fft_root_of_unity(&step, job->fs, job->inverse, k1 * roots_stride);
+            fr_t *row = job->x + k1 * job->n2 + c0;
+            for (uint64_t c = 0; c < job->tile; c++) {
+                fr_mul(&row[c], &row[c], &w);
+                fr_mul(&w, &w, &step);
+            }
+        }
+    }
+}
+
+static void fft_fr_four_step_row_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_four_step_job *job = ctx;
+    for (uint64_t r = start; r < end; r++) {
+        fr_t *row = job->x + r * job->n2;
+        fft_fr_iterative(row, row, job->inverse, job->n2, job->fs, NULL, NULL, NULL, 1);
+    }
+}
+
+static void fft_fr_four_step_transpose_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_four_step_job *job = ctx;
+    const uint64_t b = FFT_FR_FOUR_STEP_TILE;
+    for (uint64_t k2 = start * b; k2 < end * b && k2 < job->n2; k2 += b) {
+        uint64_t k2_end = k2 + b < job->n2 ? k2 + b : job->n2;
+        for (uint64_t k1 = 0; k1 < job->n1; k1 += b) {
+            uint64_t k1_end = k1 + b < job->n1 ? k1 + b : job->n1;
+            for (uint64_t i = k2; i < k2_end; i++) {
+                for (uint64_t j = k1; j < k1_end; j++) {
+                    if (job->post != NULL) {
+                        fr_mul(&job->out[i * job->n1 + j], &job->x[j * job->n2 + i], &job->post[i * job->n1 + j]);
+                    } else {
+                        job->out[i * job->n1 + j] = job->x[j * job->n2 + i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Four-step Fast Fourier Transform, with optional scaling of the inputs and outputs.
+ *
+ * The length `n = n1 * n2` input is viewed as a matrix of `n1` rows and `n2` columns. Element `(k1, k2)` of the
+ * output is then made in four steps:
+ *   1. An FFT of length `n1` down each column, done a tile of #FFT_FR_FOUR_STEP_TILE columns at a time,
+ *   2. Multiplication of element `(k1, j2)` by `w^(k1 * j2)`, where `w` is the `n`th root of unity,
+ *   3. An FFT of length `n2` along each row,
+ *   4. A transpose, so that element `(k1, k2)` ends up at position `k1 + n1 * k2`.
+ *
+ * Each of the sub-transforms has about `sqrt(n)` elements and is done entirely in cache, so that the data makes only a
+ * few round trips to memory however large it is. The twiddle multiplications are done as each tile of columns is
+ * finished, and the input and output factors are applied when copying in and in the transpose.
+ *
+ * Each step is spread over @p num_threads threads.
+ *
+ * @remark The inverse transform is not scaled by `1 / n`, except through @p factor.
+ * @remark A working array of @p n elements is allocated.
+ *
+ * @param[out] out         The results (array of length @p n)
+ * @param[in]  in          The input data (array of length @p n), which may be the same as @p out
+ * @param[in]  inverse     `false` for forward transform, `true` for inverse transform
+ * @param[in]  n           Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  fs          Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  pre         Factors to multiply the inputs by (array of length @p n), or `NULL`
+ * @param[in]  factor      A factor to multiply all the inputs by, or `NULL`
+ * @param[in]  post        Factors to multiply the outputs by (array of length @p n), or `NULL`
+ * @param[in]  num_threads The number of threads to use
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET fft_fr_four_step_scaled(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs,
+                                         const fr_t *pre, const fr_t *factor, const fr_t *post, int num_threads) {
+    int log_n = log2_pow2(n);
+    fft_fr_four_step_job job = {.out = out, .in = in, .n = n, .inverse = inverse, .fs = fs, .post = post};
+    job.load.pre = pre;
+    job.load.factor = factor;
+    job.n1 = (uint64_t)1 << ((log_n + 1) / 2);
+    job.n2 = n / job.n1;
+    job.tile = job.n2 < FFT_FR_FOUR_STEP_TILE ? job.n2 : FFT_FR_FOUR_STEP_TILE;
+
+    TRY(new_fr_array(&job.x, n));
+    parallel_for(fft_fr_four_step_load_task, &job, n, num_threads);
+    parallel_for(fft_fr_four_step_column_task, &job, job.n2 / job.tile, num_threads);
+    parallel_for(fft_fr_four_step_row_task, &job, job.n1, num_threads);
+    parallel_for(fft_fr_four_step_transpose_task, &job,
+                 (job.n2 + FFT_FR_FOUR_STEP_TILE - 1) / FFT_FR_FOUR_STEP_TILE, num_threads);
+    free(job.x);
+
+    return C_KZG_OK;
+}
+
+static void fft_fr_pruned_load_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    uint64_t r = job->h, m = job->n / r;
+    int unused_bit_len = 32 - log2_pow2(m);
+    for (uint64_t p = start; p < end; p++) {
+        uint64_t i = m == 1 ? 0 : reverse_bits(p) >> unused_bit_len;
+        fr_t x = fr_zero;
+        if (i < job->in_len) fft_fr_load(&x, &job->in[i], i, job);
+        for (uint64_t j = 0; j < r; j++) {
+            job->x[p * r + j] = x;
+        }
+    }
+}
+
+static void fft_fr_pruned_pass_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        fr_t *a = job->x + i * 2 * job->h;
+        // Only the top outputs are used, the bottom ones are left over from the butterflies
+        fr_vec_butterfly(a, a + job->h, job->w1, job->ws1, job->block);
+    }
+}
+
+/**
+ * Fast Fourier Transform of data with known zeros, computing only some of the outputs.
+ *
+ * With the inputs zero beyond the first `m`, a power of two, the bit-reversed data is zero except at multiples of
+ * `r = n / m`. The first `log2(r)` stages then only copy each non-zero element across its block of `r`, which is done
+ * as the input is permuted. With only the first `q` outputs wanted, also a power of two, the stages that combine
+ * sub-transforms of size `q` or more need only their first `q` outputs, so only `q` butterflies of each pair of
+ * sub-transforms are done. The stages in between are done in full as by #fft_fr_iterative.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data (array of length @p in_len), not overlapping @p out
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  in_len  The number of inputs, the rest being zero
+ * @param[in]  out_len The number of outputs wanted
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  factor  A factor to multiply all the inputs by, or `NULL`
+ */
+static void fft_fr_pruned_scaled(fr_t *out, const fr_t *in, bool inverse, uint64_t n, uint64_t in_len,
+                                 uint64_t out_len, const FFTSettings *fs, const fr_t *factor) {
+    uint64_t m = in_len < 2 ? 1 : next_power_of_two(in_len), q = out_len < 2 ? 1 : next_power_of_two(out_len);
+    int num_threads = n >= FFT_FR_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    fft_fr_job job = {.x = out, .in = in, .n = n, .in_len = in_len, .inverse = inverse, .fs = fs, .factor = factor};
+
+    job.h = n / m;
+    parallel_for(fft_fr_pruned_load_task, &job, m, num_threads);
+
+    // The full stages, up to sub-transforms of size q, with the early ones in cache-sized blocks as usual
+    if (job.h < q && q > FFT_FR_BLOCK_SIZE) {
+        if (job.h < FFT_FR_BLOCK_SIZE) {
+            job.block = FFT_FR_BLOCK_SIZE;
+            parallel_for(fft_fr_block_task, &job, n / FFT_FR_BLOCK_SIZE, num_threads);
+            job.h = FFT_FR_BLOCK_SIZE;
+        }
+        for (uint64_t i = 0; i < n; i += q) {
+            fft_fr_passes(out + i, q, job.h, inverse, fs, num_threads, NULL);
+        }
+        job.h = q;
+    } else if (job.h < q) {
+        job.block = q;
+        parallel_for(fft_fr_block_task, &job, n / q, num_threads);
+        job.h = q;
+    }
+
+    // The output-pruned stages
+    job.block = q;
+    for (; job.h < n; job.h *= 2) {
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, job.h);
+        parallel_for(fft_fr_pruned_pass_task, &job, n / (2 * job.h), num_threads);
+    }
+}
+
+static void fft_fr_copy_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        uint64_t r = job->bit_reversed ? reverse_bits_limited(job->n, i) : i;
+        fft_fr_load(&job->x[i], &job->in[i], r, job);
+    }
+}
+
+static void fft_fr_reversed_post_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        fr_mul(&job->x[i], &job->x[i], &job->post[reverse_bits_limited(job->n, i)]);
+    }
+}
+
+/**
+ * Part of a decimation-in-frequency pass, splitting sub-transforms of size `2 * h` into pairs of size @p h.
+ *
+ * The butterflies are `(a, b) -> (a + b, (a - b) * w^k)`, done with #fr_vec_butterfly_dif except for the first of
+ * each block, whose twiddle factor is one. A whole pass over `len` elements is butterflies `0` to `len / 2`, and any
+ * range of them may be done independently.
+ *
+ * @param[in,out] x     The data
+ * @param[in]     h     The size of the sub-transforms produced, a power of two
+ * @param[in]     w     The twiddle factors of the stage, as from #fft_stage_roots
+ * @param[in]     ws    The stride of the twiddle factors
+ * @param[in]     start The first butterfly to do
+ * @param[in]     end   One more than the last butterfly to do
+ */
+static void fft_fr_dif_pass(fr_t *x, uint64_t h, const fr_t *w, uint64_t ws, uint64_t start, uint64_t end) {
+    uint64_t i = start;
+    while (i < end) {
+        uint64_t k = i & (h - 1), j = (i - k) * 2, len = h - k < end - i ? h - k : end - i;
+        fr_t *a = &x[j + k], *b = &x[j + k + h];
+        if (k == 0) {
+            fr_t tmp;
+            fr_sub(&tmp, a, b);
+            fr_add(a, a, b);
+            *b = tmp;
+            fr_vec_butterfly_dif(a + 1, b + 1, &w[ws], ws, len - 1);
+        } else {
+            fr_vec_butterfly_dif(a, b, &w[k * ws], ws, len);
+        }
+        i += len;
+    }
+}
+
+static void fft_fr_dif_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    fft_fr_dif_pass(job->x, job->h, job->w1, job->ws1, start, end);
+}
+
+static void fft_fr_dif_block_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_fr_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        for (uint64_t h = job->block / 2; h >= 1; h /= 2) {
+            uint64_t ws;
+            const fr_t *w = fft_stage_roots(&ws, job->fs, job->inverse, h);
+            fft_fr_dif_pass(job->x + i * job->block, h, w, ws, 0, job->block / 2);
+        }
+    }
+}
+
+/**
+ * Fast Fourier Transform from natural order to bit-reversed order, without permuting the data.
+ *
+ * Decimation in frequency: each pass splits the sub-transforms in two, starting from the whole array, so the outputs
+ * come out in bit-reversed order. Once the sub-transforms fit in cache the remaining passes are run one block at a
+ * time.
+ *
+ * @param[out] out     The results, in bit-reversed order (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n), which may be the same as @p out
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  pre     Factors to multiply the inputs by (array of length @p n), or `NULL`
+ * @param[in]  factor  A factor to multiply all the inputs by, or `NULL`
+ * @param[in]  post    Factors to multiply the outputs by, in natural order (array of length @p n), or `NULL`
+ */
+static void fft_fr_dif_scaled(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs,
+                              const fr_t *pre, const fr_t *factor, const fr_t *post) {
+    int num_threads = n >= FFT_FR_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    fft_fr_job job = {.x = out, .in = in, .n = n, .inverse = inverse, .fs = fs, .pre = pre, .factor = factor};
+
+    if (n == 0) return;
+    if (in != out || pre != NULL || factor != NULL) {
+        parallel_for(fft_fr_copy_task, &job, n, num_threads);
+    }
+
+    job.block = n < FFT_FR_BLOCK_SIZE ? n : FFT_FR_BLOCK_SIZE;
+    for (job.h = n / 2; job.h >= job.block; job.h /= 2) {
+        job.w1 = fft_stage_roots(&job.ws1, fs, inverse, job.h);
+        parallel_for(fft_fr_dif_task, &job, n / 2, num_threads);
+    }
+    parallel_for(fft_fr_dif_block_task, &job, n / job.block, num_threads);
+
+    if (post != NULL) {
+        job.post = post;
+        parallel_for(fft_fr_reversed_post_task, &job, n, num_threads);
+    }
+}
+
+/**
+ * Fast Fourier Transform from bit-reversed order to natural order, without permuting the data.
+ *
+ * As #fft_fr_iterative, for input that is already in bit-reversed order.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data, in bit-reversed order (array of length @p n), which may be the same as @p out
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  pre     Factors to multiply the inputs by, in natural order (array of length @p n), or `NULL`
+ * @param[in]  factor  A factor to multiply all the inputs by, or `NULL`
+ * @param[in]  post    Factors to multiply the outputs by (array of length @p n), or `NULL`
+ */
+static void fft_fr_dit_scaled(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs,
+                              const fr_t *pre, const fr_t *factor, const fr_t *post) {
+    int num_threads = n >= FFT_FR_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    fft_fr_job job = {
+        .x = out, .in = in, .n = n, .inverse = inverse, .fs = fs, .pre = pre, .factor = factor, .bit_reversed = true};
+
+    if (n == 0) return;
+    if (in != out || pre != NULL || factor != NULL) {
+        parallel_for(fft_fr_copy_task, &job, n, num_threads);
+    }
+    fft_fr_dit_passes(&job, post, num_threads);
+}
+
+/**
+ * Fast Fourier Transform, with optional scaling of the inputs and outputs.
+ *
+ * Uses fft_fr_four_step_scaled() for large transforms, falling back to fft_fr_iterative() if its working space can't
+ * be allocated, and fft_fr_iterative() otherwise. Large transforms are spread over `fs->num_threads` threads.
+ *
+ * @remark The inverse transform is not scaled by `1 / n`, except through @p factor.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n), which may be the same as @p out
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @param[in]  pre     Factors to multiply the inputs by (array of length @p n), or `NULL`
+ * @param[in]  factor  A factor to multiply all the inputs by, or `NULL`
+ * @param[in]  post    Factors to multiply the outputs by (array of length @p n), or `NULL`
+ */
+static void fft_fr_scaled(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs,
+                          const fr_t *pre, const fr_t *factor, const fr_t *post) {
+    if (n >= FFT_FR_FOUR_STEP_MIN_LEN &&
+        fft_fr_four_step_scaled(out, in, inverse, n, fs, pre, factor, post, fs->num_threads) == C_KZG_OK) {
+        return;
+    }
+    fft_fr_iterative(out, in, inverse, n, fs, pre, factor, post, fs->num_threads);
+}
+
+/**
+ * Fast Fourier Transform, in place.
+ *
+ * See #fft_fr_iterative and #fft_fr_four_step_scaled for the methods.
+ *
+ * @remark The inverse transform is not scaled by `1 / n`.
+ *
+ * @param[in,out] data    The data to be transformed (array of length @p n)
+ * @param[in]     inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]     n       Length of the FFT, must be a power of two, less than `2^32`
+ * @param[in]     fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ */
+void fft_fr_inplace(fr_t *data, bool inverse, uint64_t n, const FFTSettings *fs) {
+    fft_fr_scaled(data, data, inverse, n, fs, NULL, NULL, NULL);
+}
+
 /**
  * The main entry point for forward and reverse FFTs over the finite field.
  *
@@ -93,21 +1051,254 @@ void fft_fr_fast(fr_t *out, const fr_t *in, uint64_t stride, const fr_t *roots,
  * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in may be the same array.
  */
 C_KZG_RET fft_fr(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
-    uint64_t stride = fs->max_width / n;
     CHECK(n <= fs->max_width);
     CHECK(is_power_of_two(n));
     if (inverse) {
         fr_t inv_len;
         fr_from_uint64(&inv_len, n);
         fr_inv(&inv_len, &inv_len);
-        fft_fr_fast(out, in, 1, fs->reverse_roots_of_unity, stride, n);
-        for (uint64_t i = 0; i < n; i++) {
-            fr_mul(&out[i], &out[i], &inv_len);
-        }
+        fft_fr_scaled(out, in, true, n, fs, NULL, &inv_len, NULL);
+    } else {
+        fft_fr_scaled(out, in, false, n, fs, NULL, NULL, NULL);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs over a coset of the roots of unity.
+ *
+ * The forward transform evaluates the polynomial with coefficients @p in at the points `shift * w^i`, where `w` is the
+ * `n`th root of unity. The inverse transform interpolates values at these points back to coefficients.
+ *
+ * This is the same as multiplying the `i`th coefficient by `shift^i` before a forward #fft_fr, or by `shift^-i` after
+ * an inverse #fft_fr, but the multiplications are folded into the first or last pass of the transform. The powers of
+ * the shift are taken from @p fs if it was cached there by #precompute_fft_coset, and calculated otherwise.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  shift   The coset shift, which must not be zero
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_fr_coset(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift,
+                       const FFTSettings *fs) {
+    const fr_t *powers;
+    fr_t *tmp;
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(!fr_is_zero(shift));
+    TRY(coset_shift_powers(&powers, &tmp, fs, shift, inverse, n));
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_fr_scaled(out, in, true, n, fs, NULL, &inv_len, powers);
+    } else {
+        fft_fr_scaled(out, in, false, n, fs, powers, NULL, NULL);
+    }
+    free(tmp);
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs of a batch of vectors of the same length, in place.
+ *
+ * Element `i` of vector `v` is at `data[i * elem_stride + v * vec_stride]`. Row-major data has `elem_stride = 1` and
+ * `vec_stride` at least @p n. Interleaved data, where the vectors are the columns of a matrix with @p count columns,
+ * has `elem_stride = count` and `vec_stride = 1`. The vectors must not overlap.
+ *
+ * The vectors are transformed side by side, so that each twiddle factor is loaded once per butterfly position rather
+ * than once per vector. With interleaved data the inner loop also runs over contiguous memory.
+ *
+ * When the batch is large, the vectors are shared out between `fs->num_threads` threads. Set this to one to do the
+ * whole batch on the calling thread.
+ *
+ * @param[in,out] data        The vectors to be transformed
+ * @param[in]     inverse     `false` for forward transform, `true` for inverse transform
+ * @param[in]     n           Length of each vector, must be a power of two
+ * @param[in]     count       The number of vectors
+ * @param[in]     elem_stride The distance between consecutive elements of a vector
+ * @param[in]     vec_stride  The distance between the starts of consecutive vectors
+ * @param[in]     fs          Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ */
+C_KZG_RET fft_fr_batch(fr_t *data, bool inverse, uint64_t n, uint64_t count, uint64_t elem_stride,
+                       uint64_t vec_stride, const FFTSettings *fs) {
+    fr_t inv_len;
+    fft_fr_batch_job job = {.x = data,
+                            .n = n,
+                            .count = count,
+                            .elem_stride = elem_stride,
+                            .vec_stride = vec_stride,
+                            .inverse = inverse,
+                            .fs = fs};
+    int num_threads = n * count >= FFT_FR_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    if (n < 2) return C_KZG_OK;
+
+    if (inverse) {
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        job.factor = &inv_len;
+    }
+    parallel_for(fft_fr_batch_task, &job, count, num_threads);
+
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs over the finite field, using the four-step method.
+ *
+ * #fft_fr switches to this method automatically for large transforms, see #fft_fr_four_step_scaled. It is available
+ * separately for testing and benchmarking at any size.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_fr_four_step(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        return fft_fr_four_step_scaled(out, in, true, n, fs, NULL, &inv_len, NULL, fs->num_threads);
+    }
+    return fft_fr_four_step_scaled(out, in, false, n, fs, NULL, NULL, NULL, fs->num_threads);
+}
+
+/**
+ * Forward and reverse FFTs of data that is known to be zero beyond its first @p in_len elements, computing only the
+ * first @p out_len results.
+ *
+ * This is the same as zero-padding the input to length @p n for #fft_fr and discarding all but the first @p out_len
+ * outputs, but does not read the padding and skips the butterflies that depend only on it or contribute only to the
+ * discarded outputs. See #fft_fr_pruned_scaled. The saving is about `log2(n / in_len) / log2(n)` of the work for the
+ * inputs, and most of the last `log2(n / out_len)` stages for the outputs.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data (array of length @p in_len)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  in_len  The number of inputs, the rest being zero, at most @p n
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in must not overlap.
+ */
+C_KZG_RET fft_fr_pruned(fr_t *out, const fr_t *in, bool inverse, uint64_t n, uint64_t in_len, uint64_t out_len,
+                        const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(in_len <= n);
+    CHECK(out_len <= n);
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_fr_pruned_scaled(out, in, true, n, in_len, out_len, fs, &inv_len);
+    } else {
+        fft_fr_pruned_scaled(out, in, false, n, in_len, out_len, fs, NULL);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs that take natural order to bit-reversed order, without permuting the data.
+ *
+ * `out[i]` is `fft_fr(in)[reverse_bits_limited(n, i)]`. Pairing this with #fft_fr_dit, which takes bit-reversed order
+ * back to natural order, leaves convolutions and similar pipelines with no permutations at all, since pointwise
+ * operations do not care about the order. See #fft_fr_dif_scaled.
+ *
+ * With a @p shift, the transforms are over the coset as in #fft_fr_coset.
+ *
+ * @param[out] out     The results, in bit-reversed order (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  shift   The coset shift, which must not be zero, or `NULL` for none
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_fr_dif(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift, const FFTSettings *fs) {
+    const fr_t *powers = NULL;
+    fr_t *tmp = NULL, inv_len;
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(shift == NULL || !fr_is_zero(shift));
+    if (shift != NULL) TRY(coset_shift_powers(&powers, &tmp, fs, shift, inverse, n));
+    if (inverse) {
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_fr_dif_scaled(out, in, true, n, fs, NULL, &inv_len, powers);
+    } else {
+        fft_fr_dif_scaled(out, in, false, n, fs, powers, NULL, NULL);
+    }
+    free(tmp);
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs that take bit-reversed order to natural order, without permuting the data.
+ *
+ * Undoes #fft_fr_dif in either direction: `out` is `fft_fr(x)`, where `x[i]` is `in[reverse_bits_limited(n, i)]`. See
+ * #fft_fr_dit_scaled.
+ *
+ * With a @p shift, the transforms are over the coset as in #fft_fr_coset.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data, in bit-reversed order (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  shift   The coset shift, which must not be zero, or `NULL` for none
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_fr_dit(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift, const FFTSettings *fs) {
+    const fr_t *powers = NULL;
+    fr_t *tmp = NULL, inv_len;
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(shift == NULL || !fr_is_zero(shift));
+    if (shift != NULL) TRY(coset_shift_powers(&powers, &tmp, fs, shift, inverse, n));
+    if (inverse) {
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_fr_dit_scaled(out, in, true, n, fs, NULL, &inv_len, powers);
     } else {
-        fft_fr_fast(out, in, 1, fs->expanded_roots_of_unity, stride, n);
+        fft_fr_dit_scaled(out, in, false, n, fs, powers, NULL, NULL);
     }
+    free(tmp);
     return C_KZG_OK;
 }
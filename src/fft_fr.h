@@ -20,4 +20,14 @@
 
 void fft_fr_slow(fr_t *out, const fr_t *in, uint64_t stride, const fr_t *roots, uint64_t roots_stride, uint64_t n);
 void fft_fr_fast(fr_t *out, const fr_t *in, uint64_t stride, const fr_t *roots, uint64_t roots_stride, uint64_t n);
+void fft_fr_inplace(fr_t *data, bool inverse, uint64_t n, const FFTSettings *fs);
 C_KZG_RET fft_fr(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs);
+C_KZG_RET fft_fr_coset(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift,
+                       const FFTSettings *fs);
+C_KZG_RET fft_fr_batch(fr_t *data, bool inverse, uint64_t n, uint64_t count, uint64_t elem_stride,
+                       uint64_t vec_stride, const FFTSettings *fs);
+C_KZG_RET fft_fr_four_step(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs);
+C_KZG_RET fft_fr_pruned(fr_t *out, const fr_t *in, bool inverse, uint64_t n, uint64_t in_len, uint64_t out_len,
+                        const FFTSettings *fs);
+C_KZG_RET fft_fr_dif(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift, const FFTSettings *fs);
+C_KZG_RET fft_fr_dit(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const fr_t *shift, const FFTSettings *fs);
@@ -22,13 +22,23 @@
 #include "test_util.h"
 #include "fft_fr.h"
 
+typedef C_KZG_RET (*fft_fn)(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs);
+
+// The original recursive, out-of-place FFT, for comparison.
+C_KZG_RET fft_fr_recursive(fr_t *out, const fr_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
+    (void)inverse;
+    fft_fr_fast(out, in, 1, fs->expanded_roots_of_unity, fs->max_width / n, n);
+    return C_KZG_OK;
+}
+
 // Run the benchmark for `max_seconds` and return the time per iteration in nanoseconds.
-long run_bench(int scale, int max_seconds) {
+long run_bench(fft_fn fn, int scale, bool stage_roots, int max_seconds) {
     timespec_t t0, t1;
     unsigned long total_time = 0, nits = 0;
     FFTSettings fs;
 
     assert(C_KZG_OK == new_fft_settings(&fs, scale));
+    if (stage_roots) assert(C_KZG_OK == precompute_fft_settings(&fs));
 
     // Allocate on the heap to avoid stack overflow for large sizes
     fr_t *data, *out;
@@ -42,7 +52,7 @@ long run_bench(int scale, int max_seconds) {
 
     while (total_time < max_seconds * NANO) {
         clock_gettime(CLOCK_REALTIME, &t0);
-        assert(C_KZG_OK == fft_fr(out, data, false, fs.max_width, &fs));
+        assert(C_KZG_OK == fn(out, data, false, fs.max_width, &fs));
         clock_gettime(CLOCK_REALTIME, &t1);
         nits++;
         total_time += tdiff(t0, t1);
@@ -55,6 +65,42 @@ long run_bench(int scale, int max_seconds) {
     return total_time / nits;
 }
 
+// As run_bench(), but for `count` vectors transformed one at a time by fft_fr, or together by fft_fr_batch.
+long run_bench_batch(int scale, uint64_t count, int layout, int max_seconds) {
+    timespec_t t0, t1;
+    unsigned long total_time = 0, nits = 0;
+    FFTSettings fs;
+
+    assert(C_KZG_OK == new_fft_settings(&fs, scale));
+    uint64_t n = fs.max_width;
+
+    fr_t *data = malloc(n * count * sizeof(fr_t));
+    for (uint64_t i = 0; i < n * count; i++) {
+        data[i] = rand_fr();
+    }
+
+    while (total_time < max_seconds * NANO) {
+        clock_gettime(CLOCK_REALTIME, &t0);
+        if (layout == 0) {
+            for (uint64_t v = 0; v < count; v++) {
+                assert(C_KZG_OK == fft_fr(data + v * n, data + v * n, false, n, &fs));
+            }
+        } else if (layout == 1) {
+            assert(C_KZG_OK == fft_fr_batch(data, false, n, count, 1, n, &fs));
+        } else {
+            assert(C_KZG_OK == fft_fr_batch(data, false, n, count, count, 1, &fs));
+        }
+        clock_gettime(CLOCK_REALTIME, &t1);
+        nits++;
+        total_time += tdiff(t0, t1);
+    }
+
+    free(data);
+    free_fft_settings(&fs);
+
+    return total_time / nits;
+}
+
 int main(int argc, char *argv[]) {
     int nsec = 0;
 
@@ -76,7 +122,15 @@ int main(int argc, char *argv[]) {
 
     printf("*** Benchmarking FFT_fr, %d second%s per test.\n", nsec, nsec == 1 ? "" : "s");
     for (int scale = 4; scale <= 15; scale++) {
-        printf("fft_fr/scale_%d %lu ns/op\n", scale, run_bench(scale, nsec));
+        printf("fft_fr_recursive/scale_%d %lu ns/op\n", scale, run_bench(fft_fr_recursive, scale, false, nsec));
+        printf("fft_fr/scale_%d %lu ns/op\n", scale, run_bench(fft_fr, scale, false, nsec));
+        printf("fft_fr_stage_roots/scale_%d %lu ns/op\n", scale, run_bench(fft_fr, scale, true, nsec));
+        printf("fft_fr_four_step/scale_%d %lu ns/op\n", scale, run_bench(fft_fr_four_step, scale, false, nsec));
+    }
+    for (int scale = 4; scale <= 12; scale++) {
+        printf("fft_fr_rows_128/scale_%d %lu ns/op\n", scale, run_bench_batch(scale, 128, 0, nsec));
+        printf("fft_fr_batch_row_major_128/scale_%d %lu ns/op\n", scale, run_bench_batch(scale, 128, 1, nsec));
+        printf("fft_fr_batch_interleaved_128/scale_%d %lu ns/op\n", scale, run_bench_batch(scale, 128, 2, nsec));
     }
 
     return EXIT_SUCCESS;
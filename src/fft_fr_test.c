@@ -16,7 +16,9 @@
 
 #include "../inc/acutest.h"
 #include "test_util.h"
+#include "c_kzg_util.h"
 #include "fft_fr.h"
+#include "utility.h"
 
 const uint64_t inv_fft_expected[][4] = {
     {0x7fffffff80000008L, 0xa9ded2017fff2dffL, 0x199cec0404d0ec02L, 0x39f6d3a994cebea4L},
@@ -41,13 +43,16 @@ void compare_sft_fft(void) {
     unsigned int size = 12;
     FFTSettings fs;
     TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
-    fr_t data[fs.max_width], out0[fs.max_width], out1[fs.max_width];
+    fr_t data[fs.max_width], out0[fs.max_width], out1[fs.max_width], roots[fs.max_width + 1];
     for (int i = 0; i < fs.max_width; i++) {
         fr_from_uint64(data + i, i);
     }
 
+    // The slow transform needs all the roots, not just the first half in the settings
+    TEST_CHECK(expand_root_of_unity(roots, &fs.root_of_unity, fs.max_width) == C_KZG_OK);
+
     // Do both fast and slow transforms
-    fft_fr_slow(out0, data, 1, fs.expanded_roots_of_unity, 1, fs.max_width);
+    fft_fr_slow(out0, data, 1, roots, 1, fs.max_width);
     fft_fr_fast(out1, data, 1, fs.expanded_roots_of_unity, 1, fs.max_width);
 
     // Verify the results are identical
@@ -58,6 +63,50 @@ void compare_sft_fft(void) {
     free_fft_settings(&fs);
 }
 
+void compare_fft_inplace(void) {
+    // Cover odd and even numbers of stages, and sizes both below and above the block size
+    unsigned int size = 12;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    fr_t data[fs.max_width], out0[fs.max_width], out1[fs.max_width];
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    for (unsigned int scale = 0; scale <= size; scale++) {
+        uint64_t n = (uint64_t)1 << scale;
+        fft_fr_fast(out0, data, 1, fs.expanded_roots_of_unity, fs.max_width / n, n);
+        for (uint64_t i = 0; i < n; i++) {
+            out1[i] = data[i];
+        }
+        fft_fr_inplace(out1, false, n, &fs);
+        for (uint64_t i = 0; i < n; i++) {
+            TEST_CHECK(fr_equal(out0 + i, out1 + i));
+            TEST_MSG("Scale %d, index %lu", scale, i);
+        }
+    }
+
+    free_fft_settings(&fs);
+}
+
+void fft_in_place_aliasing(void) {
+    unsigned int size = 5;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    fr_t data[fs.max_width], out[fs.max_width];
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    TEST_CHECK(fft_fr(out, data, false, fs.max_width, &fs) == C_KZG_OK);
+    TEST_CHECK(fft_fr(data, data, false, fs.max_width, &fs) == C_KZG_OK);
+    for (int i = 0; i < fs.max_width; i++) {
+        TEST_CHECK(fr_equal(out + i, data + i));
+    }
+
+    free_fft_settings(&fs);
+}
+
 void roundtrip_fft(void) {
     // Initialise: ascending values of i, and arbitrary size
     unsigned int size = 12;
@@ -128,12 +177,341 @@ void stride_fft(void) {
     free_fft_settings(&fs2);
 }
 
+void stage_roots_fft(void) {
+    unsigned int size = 12;
+    uint64_t width = (uint64_t)1 << 11;
+    FFTSettings fs1, fs2;
+    TEST_CHECK(new_fft_settings(&fs1, size) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings(&fs2, size) == C_KZG_OK);
+    TEST_CHECK(precompute_fft_settings(&fs2) == C_KZG_OK);
+    fr_t data[width], coeffs1[width], coeffs2[width];
+    for (int i = 0; i < width; i++) {
+        data[i] = rand_fr();
+    }
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        TEST_CHECK(fft_fr(coeffs1, data, inverse, width, &fs1) == C_KZG_OK);
+        TEST_CHECK(fft_fr(coeffs2, data, inverse, width, &fs2) == C_KZG_OK);
+        for (int i = 0; i < width; i++) {
+            TEST_CHECK(fr_equal(coeffs1 + i, coeffs2 + i));
+        }
+    }
+
+    free_fft_settings(&fs1);
+    free_fft_settings(&fs2);
+}
+
+void parallel_fft(void) {
+    // Large enough to be split into blocks and shared between threads
+    unsigned int size = 13;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    fr_t *data, *coeffs1, *coeffs2;
+    TEST_CHECK(new_fr_array(&data, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&coeffs1, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&coeffs2, fs.max_width) == C_KZG_OK);
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        fs.num_threads = 1;
+        TEST_CHECK(fft_fr(coeffs1, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        fs.num_threads = 3;
+        TEST_CHECK(fft_fr(coeffs2, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        for (int i = 0; i < fs.max_width; i++) {
+            TEST_CHECK(fr_equal(coeffs1 + i, coeffs2 + i));
+        }
+        // A count below one means one thread
+        fs.num_threads = -1;
+        TEST_CHECK(fft_fr(coeffs2, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        for (int i = 0; i < fs.max_width; i++) {
+            TEST_CHECK(fr_equal(coeffs1 + i, coeffs2 + i));
+        }
+    }
+
+    free(data);
+    free(coeffs1);
+    free(coeffs2);
+    free_fft_settings(&fs);
+}
+
+void coset_fft(void) {
+    // Large enough to be split into blocks
+    unsigned int size = 11;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    fr_t *data, *scaled, *expected, *out;
+    TEST_CHECK(new_fr_array(&data, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&scaled, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&expected, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&out, fs.max_width) == C_KZG_OK);
+    fr_t shift, inv_shift, power;
+    fr_from_uint64(&shift, 7);
+    fr_inv(&inv_shift, &shift);
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    for (uint64_t n = 1; n <= fs.max_width; n *= 2) {
+        for (int cached = 0; cached < 2; cached++) {
+            if (cached) TEST_CHECK(precompute_fft_coset(&fs, &shift) == C_KZG_OK);
+
+            // Forward: scale the coefficients by shift^i, then transform
+            power = fr_one;
+            for (int i = 0; i < n; i++) {
+                fr_mul(&scaled[i], &data[i], &power);
+                fr_mul(&power, &power, &shift);
+            }
+            TEST_CHECK(fft_fr(expected, scaled, false, n, &fs) == C_KZG_OK);
+            TEST_CHECK(fft_fr_coset(out, data, false, n, &shift, &fs) == C_KZG_OK);
+            for (int i = 0; i < n; i++) {
+                TEST_CHECK(fr_equal(&expected[i], &out[i]));
+            }
+
+            // Inverse: transform, then scale the coefficients by shift^-i
+            TEST_CHECK(fft_fr(expected, data, true, n, &fs) == C_KZG_OK);
+            power = fr_one;
+            for (int i = 0; i < n; i++) {
+                fr_mul(&expected[i], &expected[i], &power);
+                fr_mul(&power, &power, &inv_shift);
+            }
+            TEST_CHECK(fft_fr_coset(out, data, true, n, &shift, &fs) == C_KZG_OK);
+            for (int i = 0; i < n; i++) {
+                TEST_CHECK(fr_equal(&expected[i], &out[i]));
+            }
+
+            // Round trip, in place
+            TEST_CHECK(fft_fr_coset(out, out, false, n, &shift, &fs) == C_KZG_OK);
+            for (int i = 0; i < n; i++) {
+                TEST_CHECK(fr_equal(&data[i], &out[i]));
+            }
+        }
+        free_fft_settings(&fs);
+        TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    }
+
+    TEST_CHECK(fft_fr_coset(out, data, false, fs.max_width, &fr_zero, &fs) == C_KZG_BADARGS);
+    TEST_CHECK(precompute_fft_coset(&fs, &fr_zero) == C_KZG_BADARGS);
+
+    free(data);
+    free(scaled);
+    free(expected);
+    free(out);
+    free_fft_settings(&fs);
+}
+
+void batch_fft(void) {
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, 11) == C_KZG_OK);
+    // Few long vectors, split into blocks, and many short ones, with padding between the rows
+    const uint64_t scales[] = {11, 4}, counts[] = {3, 100}, pad = 5;
+
+    for (int t = 0; t < 2; t++) {
+        uint64_t n = (uint64_t)1 << scales[t], count = counts[t], row = n + pad;
+        fr_t *expected, *interleaved, *row_major;
+        TEST_CHECK(new_fr_array(&expected, n * count) == C_KZG_OK);
+        TEST_CHECK(new_fr_array(&interleaved, n * count) == C_KZG_OK);
+        TEST_CHECK(new_fr_array(&row_major, row * count) == C_KZG_OK);
+
+        for (int inverse = 0; inverse < 2; inverse++) {
+            for (uint64_t v = 0; v < count; v++) {
+                for (uint64_t i = 0; i < n; i++) {
+                    expected[v * n + i] = interleaved[i * count + v] = row_major[v * row + i] = rand_fr();
+                }
+                TEST_CHECK(fft_fr(expected + v * n, expected + v * n, inverse, n, &fs) == C_KZG_OK);
+            }
+
+            fs.num_threads = 1;
+            TEST_CHECK(fft_fr_batch(interleaved, inverse, n, count, count, 1, &fs) == C_KZG_OK);
+            fs.num_threads = 3;
+            TEST_CHECK(fft_fr_batch(row_major, inverse, n, count, 1, row, &fs) == C_KZG_OK);
+            for (uint64_t v = 0; v < count; v++) {
+                for (uint64_t i = 0; i < n; i++) {
+                    TEST_CHECK(fr_equal(&expected[v * n + i], &interleaved[i * count + v]));
+                    TEST_CHECK(fr_equal(&expected[v * n + i], &row_major[v * row + i]));
+                }
+            }
+        }
+
+        free(expected);
+        free(interleaved);
+        free(row_major);
+    }
+
+    free_fft_settings(&fs);
+}
+
+void four_step_fft(void) {
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, 11) == C_KZG_OK);
+    fr_t *data, *expected, *out;
+    TEST_CHECK(new_fr_array(&data, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&expected, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&out, fs.max_width) == C_KZG_OK);
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    // Square and non-square matrices, with fewer and more columns than a tile
+    for (uint64_t n = 1; n <= fs.max_width; n *= 2) {
+        for (int inverse = 0; inverse < 2; inverse++) {
+            fs.num_threads = 1;
+            TEST_CHECK(fft_fr(expected, data, inverse, n, &fs) == C_KZG_OK);
+            TEST_CHECK(fft_fr_four_step(out, data, inverse, n, &fs) == C_KZG_OK);
+            for (int i = 0; i < n; i++) {
+                TEST_CHECK(fr_equal(&expected[i], &out[i]));
+            }
+
+            // In place, on several threads
+            fs.num_threads = 3;
+            TEST_CHECK(fft_fr_four_step(out, out, !inverse, n, &fs) == C_KZG_OK);
+            for (int i = 0; i < n; i++) {
+                TEST_CHECK(fr_equal(&data[i], &out[i]));
+            }
+        }
+    }
+
+    free(data);
+    free(expected);
+    free(out);
+    free_fft_settings(&fs);
+}
+
+void pruned_fft(void) {
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, 12) == C_KZG_OK);
+    fr_t *data, *expected, *out;
+    TEST_CHECK(new_fr_array(&data, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&expected, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&out, fs.max_width) == C_KZG_OK);
+
+    // Compare against zero-padded full transforms, with the largest size on several threads
+    const uint64_t sizes[] = {1, 2, 8, 64, 4096};
+    for (int s = 0; s < sizeof sizes / sizeof sizes[0]; s++) {
+        uint64_t n = sizes[s];
+        const uint64_t lens[] = {0, 1, 3, n / 2, n};
+        fs.num_threads = n == fs.max_width ? 3 : 1;
+        for (int a = 0; a < 5; a++) {
+            uint64_t in_len = lens[a] < n ? lens[a] : n;
+            for (uint64_t i = 0; i < n; i++) {
+                data[i] = i < in_len ? rand_fr() : fr_zero;
+            }
+            for (int inverse = 0; inverse < 2; inverse++) {
+                TEST_CHECK(fft_fr(expected, data, inverse, n, &fs) == C_KZG_OK);
+                for (int b = 0; b < 5; b++) {
+                    uint64_t out_len = lens[b] < n ? lens[b] : n;
+                    TEST_CHECK(fft_fr_pruned(out, data, inverse, n, in_len, out_len, &fs) == C_KZG_OK);
+                    for (uint64_t i = 0; i < out_len; i++) {
+                        TEST_CHECK(fr_equal(&expected[i], &out[i]));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(fft_fr_pruned(out, data, false, 8, 9, 8, &fs) == C_KZG_BADARGS);
+    TEST_CHECK(fft_fr_pruned(out, data, false, 8, 8, 9, &fs) == C_KZG_BADARGS);
+
+    free(data);
+    free(expected);
+    free(out);
+    free_fft_settings(&fs);
+}
+
+void dif_dit_fft(void) {
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, 12) == C_KZG_OK);
+    fr_t *data, *expected, *out, shift;
+    TEST_CHECK(new_fr_array(&data, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&expected, fs.max_width) == C_KZG_OK);
+    TEST_CHECK(new_fr_array(&out, fs.max_width) == C_KZG_OK);
+    fr_from_uint64(&shift, 7);
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = rand_fr();
+    }
+
+    // Sizes either side of the cache block, with and without a coset shift, the largest on several threads
+    for (uint64_t n = 1; n <= fs.max_width; n *= 4) {
+        fs.num_threads = n == fs.max_width ? 3 : 1;
+        for (int coset = 0; coset < 2; coset++) {
+            const fr_t *s = coset ? &shift : NULL;
+            for (int inverse = 0; inverse < 2; inverse++) {
+                // DIF gives the bit-reversed result
+                if (coset) {
+                    TEST_CHECK(fft_fr_coset(expected, data, inverse, n, &shift, &fs) == C_KZG_OK);
+                } else {
+                    TEST_CHECK(fft_fr(expected, data, inverse, n, &fs) == C_KZG_OK);
+                }
+                TEST_CHECK(fft_fr_dif(out, data, inverse, n, s, &fs) == C_KZG_OK);
+                for (uint64_t i = 0; i < n; i++) {
+                    TEST_CHECK(fr_equal(&expected[reverse_bits_limited(n, i)], &out[i]));
+                }
+
+                // DIT, in place, takes it back
+                TEST_CHECK(fft_fr_dit(out, out, !inverse, n, s, &fs) == C_KZG_OK);
+                for (uint64_t i = 0; i < n; i++) {
+                    TEST_CHECK(fr_equal(&data[i], &out[i]));
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(fft_fr_dif(out, data, false, fs.max_width, &fr_zero, &fs) == C_KZG_BADARGS);
+    TEST_CHECK(fft_fr_dit(out, data, false, fs.max_width * 2, NULL, &fs) == C_KZG_BADARGS);
+
+    free(data);
+    free(expected);
+    free(out);
+    free_fft_settings(&fs);
+}
+
+void small_fft(void) {
+    // Every size up to a few blocks of the unrolled kernels, with settings just big enough and with the stage tables
+    for (unsigned int size = 1; size <= 6; size++) {
+        for (int precompute = 0; precompute < 2; precompute++) {
+            FFTSettings fs;
+            TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+            if (precompute) TEST_CHECK(precompute_fft_settings(&fs) == C_KZG_OK);
+            fr_t data[fs.max_width], expected[fs.max_width], out[fs.max_width], roots[fs.max_width + 1];
+            for (int i = 0; i < fs.max_width; i++) {
+                data[i] = rand_fr();
+            }
+            TEST_CHECK(expand_root_of_unity(roots, &fs.root_of_unity, fs.max_width) == C_KZG_OK);
+
+            for (uint64_t n = 1; n <= fs.max_width; n *= 2) {
+                fft_fr_slow(expected, data, 1, roots, fs.max_width / n, n);
+                TEST_CHECK(fft_fr(out, data, false, n, &fs) == C_KZG_OK);
+                for (uint64_t i = 0; i < n; i++) {
+                    TEST_CHECK(fr_equal(&expected[i], &out[i]));
+                }
+                TEST_CHECK(fft_fr(out, out, true, n, &fs) == C_KZG_OK);
+                for (uint64_t i = 0; i < n; i++) {
+                    TEST_CHECK(fr_equal(&data[i], &out[i]));
+                }
+            }
+
+            free_fft_settings(&fs);
+        }
+    }
+}
+
 TEST_LIST = {
     {"FFT_FR_TEST", title},
     {"compare_sft_fft", compare_sft_fft},
+    {"compare_fft_inplace", compare_fft_inplace},
+    {"fft_in_place_aliasing", fft_in_place_aliasing},
     {"roundtrip_fft", roundtrip_fft},
     {"inverse_fft", inverse_fft},
     {"stride_fft", stride_fft},
+    {"stage_roots_fft", stage_roots_fft},
+    {"parallel_fft", parallel_fft},
+    {"coset_fft", coset_fft},
+    {"batch_fft", batch_fft},
+    {"four_step_fft", four_step_fft},
+    {"pruned_fft", pruned_fft},
+    {"dif_dit_fft", dif_dit_fft},
+    {"small_fft", small_fft},
 
     {NULL, NULL} /* zero record marks the end of the list */
 };
@@ -27,6 +27,7 @@
 
 #include "fft_g1.h"
 #include "c_kzg_util.h"
+#include "parallel.h"
 #include "utility.h"
 
 /**
@@ -64,7 +65,7 @@ void fft_g1_slow(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots,
  * @param[out] out    The results (array of length @p n)
  * @param[in]  in     The input data (array of length @p n * @p stride)
  * @param[in]  stride The input data stride
- * @param[in]  roots  Roots of unity (array of length @p n * @p roots_stride)
+ * @param[in]  roots  Roots of unity (array of length @p n / 2 * @p roots_stride)
  * @param[in]  roots_stride The stride interval among the roots of unity
  * @param[in]  n      Length of the FFT, must be a power of two
  */
@@ -84,9 +85,349 @@ void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots,
     }
 }
 
+/** The twiddle factors of one stage of a G1 FFT. */
+typedef struct {
+    const fr_t *roots;                /**< The twiddle factors, as returned by #fft_stage_roots */
+    uint64_t stride;                  /**< The stride of @p roots */
+    const g1_mul_recoding_t *recoded; /**< The recoded twiddle factors, or `NULL` if the settings have none */
+    uint64_t recoded_stride;          /**< The stride of @p recoded */
+} fft_g1_twiddles;
+
+/**
+ * Find the twiddle factors for one stage of a G1 FFT.
+ *
+ * @param[out] out     The twiddle factors, with their recodings if #precompute_fft_recodings has been run
+ * @param[in]  fs      The FFT settings, with `max_width` at least `2 * h`
+ * @param[in]  inverse `false` for the forward transform, `true` for the inverse transform
+ * @param[in]  h       The size of the sub-transforms combined in this stage, a power of two
+ */
+static void fft_g1_stage_twiddles(fft_g1_twiddles *out, const FFTSettings *fs, bool inverse, uint64_t h) {
+    out->roots = fft_stage_roots(&out->stride, fs, inverse, h);
+    out->recoded = fft_stage_recodings(&out->recoded_stride, fs, inverse, h);
+}
+
+/**
+ * Multiply a G1 group element by the `k`th twiddle factor of a stage, using its recoding if there is one.
+ *
+ * @param[out] out The product, which may be the same as @p a
+ * @param[in]  a   The G1 group element
+ * @param[in]  w   The twiddle factors of the stage
+ * @param[in]  k   The index of the twiddle factor
+ */
+static inline void fft_g1_mul_twiddle(g1_t *out, const g1_t *a, const fft_g1_twiddles *w, uint64_t k) {
+    if (w->recoded != NULL) {
+        g1_mul_recoded(out, a, &w->recoded[k * w->recoded_stride]);
+    } else {
+        g1_mul(out, a, &w->roots[k * w->stride]);
+    }
+}
+
+/**
+ * Read one input of #fft_g1_stages, multiplied by its factor if there is one.
+ *
+ * @param[out] out The input, scaled
+ * @param[in]  in  The input
+ * @param[in]  pre The factor to multiply by, or `NULL`
+ */
+static inline void fft_g1_load(g1_t *out, const g1_t *in, const fr_t *pre) {
+    if (pre != NULL && !fr_is_one(pre)) {
+        g1_mul(out, in, pre);
+    } else {
+        *out = *in;
+    }
+}
+
+/**
+ * Fast Fourier Transform, taking the twiddle factors for each stage from the FFT settings.
+ *
+ * As #fft_g1_fast, but uses the per-stage roots of unity and the recoded roots when the settings have them. The
+ * inputs may be multiplied by factors as they are read, which costs nothing extra when they are one.
+ *
+ * Work on known zeros and unwanted outputs is skipped. Only the first @p in_len inputs are read, the rest being taken
+ * as the identity, and a sub-transform with at most one non-zero input is that input copied to all its outputs. Full
+ * sub-transforms of size two are unrolled rather than recursed into, since their twiddle factor is one. Only
+ * the first @p out_len outputs are computed, so the butterflies that would produce only later outputs are skipped.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data (array of length @p in_len * @p stride)
+ * @param[in]  pre     Factors to multiply the inputs by, with the same layout as @p in, or `NULL`
+ * @param[in]  stride  The input data stride
+ * @param[in]  in_len  The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      The FFT settings, with `max_width` at least @p n
+ */
+static void fft_g1_stages(g1_t *out, const g1_t *in, const fr_t *pre, uint64_t stride, uint64_t in_len,
+                          uint64_t out_len, bool inverse, uint64_t n, const FFTSettings *fs) {
+    uint64_t half = n / 2;
+    if (n == 2 && in_len == 2) {
+        // Unrolled, as the only twiddle factor is one
+        g1_t a, b;
+        fft_g1_load(&a, in, pre);
+        fft_g1_load(&b, in + stride, pre == NULL ? NULL : pre + stride);
+        if (out_len > 1) g1_sub(&out[1], &a, &b);
+        g1_add_or_dbl(&out[0], &a, &b);
+        return;
+    }
+    if (in_len > 1) {
+        uint64_t sub_out_len = out_len < half ? out_len : half;
+        fft_g1_twiddles w;
+        fft_g1_stage_twiddles(&w, fs, inverse, half);
+        fft_g1_stages(out, in, pre, stride * 2, (in_len + 1) / 2, sub_out_len, inverse, half, fs);
+        fft_g1_stages(out + half, in + stride, pre == NULL ? NULL : pre + stride, stride * 2, in_len / 2,
+                      sub_out_len, inverse, half, fs);
+        for (uint64_t i = 0; i < sub_out_len; i++) {
+            g1_t y_times_root;
+            fft_g1_mul_twiddle(&y_times_root, &out[i + half], &w, i);
+            if (i + half < out_len) g1_sub(&out[i + half], &out[i], &y_times_root);
+            g1_add_or_dbl(&out[i], &out[i], &y_times_root);
+        }
+        return;
+    }
+
+    g1_t x;
+    if (in_len == 0) {
+        x = g1_identity;
+    } else {
+        fft_g1_load(&x, in, pre);
+    }
+    for (uint64_t i = 0; i < out_len; i++) {
+        out[i] = x;
+    }
+}
+
+/**
+ * The smallest FFT that fft_g1() spreads over several threads.
+ *
+ * Group operations are expensive enough that even fairly small transforms are worth splitting.
+ */
+#define FFT_G1_PARALLEL_MIN_LEN 64
+
+/**
+ * The number of independent sub-transforms per thread in fft_g1_parallel().
+ *
+ * Having a few per thread keeps the threads evenly loaded when the thread count is not a power of two.
+ */
+#define FFT_G1_SUBS_PER_THREAD 4
+
+/** The shared state of the tasks making up one parallel transform. */
+typedef struct {
+    g1_t *out;             /**< The results */
+    const g1_t *in;        /**< The input data */
+    const fr_t *pre;       /**< Factors to multiply the inputs by, or `NULL` */
+    uint64_t in_len;       /**< The number of inputs, the rest being the identity */
+    uint64_t out_len;      /**< The number of outputs wanted */
+    uint64_t num_subs;     /**< The number of independent sub-transforms */
+    uint64_t sub_len;      /**< The length of each sub-transform */
+    uint64_t half;         /**< The size of the sub-transforms being combined in the current level */
+    uint64_t num_k;        /**< The number of butterflies of each pair of sub-transforms in the current level */
+    fft_g1_twiddles w;     /**< Twiddle factors for the current level */
+    const fr_t *scale;     /**< The factor to scale by */
+    const fr_t *post;      /**< Further factors to scale the outputs by, indexed by position, or `NULL` */
+    bool inverse;          /**< `true` for the inverse transform */
+    const FFTSettings *fs; /**< The FFT settings */
+} fft_g1_job;
+
+static void fft_g1_sub_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_g1_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        uint64_t offset = reverse_bits_limited(job->num_subs, i);
+        uint64_t in_len = job->in_len > offset ? (job->in_len - offset + job->num_subs - 1) / job->num_subs : 0;
+        uint64_t out_len = job->out_len < job->sub_len ? job->out_len : job->sub_len;
+        fft_g1_stages(job->out + i * job->sub_len, job->in + offset, job->pre == NULL ? NULL : job->pre + offset,
+                      job->num_subs, in_len, out_len, job->inverse, job->sub_len, job->fs);
+    }
+}
+
+static void fft_g1_butterfly_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_g1_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        uint64_t k = i % job->num_k, j = (i / job->num_k) * 2 * job->half;
+        g1_t y_times_root, *a = &job->out[j + k], *b = &job->out[j + k + job->half];
+        fft_g1_mul_twiddle(&y_times_root, b, &job->w, k);
+        if (k + job->half < job->out_len) g1_sub(b, a, &y_times_root);
+        g1_add_or_dbl(a, a, &y_times_root);
+    }
+}
+
+static void fft_g1_scale_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_g1_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        if (job->post != NULL) {
+            fr_t scale;
+            fr_mul(&scale, job->scale, &job->post[i]);
+            g1_mul(&job->out[i], &job->out[i], &scale);
+        } else {
+            g1_mul(&job->out[i], &job->out[i], job->scale);
+        }
+    }
+}
+
+/**
+ * Fast Fourier Transform, spread over several threads.
+ *
+ * The top levels of the recursion in #fft_g1_stages are unrolled, leaving a number of independent sub-transforms
+ * that are shared between the threads. The levels that combine them are then done in turn, each with its
+ * butterflies shared between the threads. Work on known zeros and unwanted outputs is skipped as in #fft_g1_stages.
+ *
+ * @param[out] out         The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in          The input data (array of length @p in_len)
+ * @param[in]  pre         Factors to multiply the inputs by (array of length @p in_len), or `NULL`
+ * @param[in]  in_len      The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  out_len     The number of outputs wanted, at most @p n
+ * @param[in]  inverse     `false` for forward transform, `true` for inverse transform
+ * @param[in]  n           Length of the FFT, must be a power of two
+ * @param[in]  fs          The FFT settings, with `max_width` at least @p n
+ * @param[in]  num_threads The number of threads to use
+ */
+static void fft_g1_parallel(g1_t *out, const g1_t *in, const fr_t *pre, uint64_t in_len, uint64_t out_len,
+                            bool inverse, uint64_t n, const FFTSettings *fs, int num_threads) {
+    fft_g1_job job = {
+        .out = out, .in = in, .pre = pre, .in_len = in_len, .out_len = out_len, .inverse = inverse, .fs = fs};
+
+    job.num_subs = next_power_of_two((uint64_t)num_threads * FFT_G1_SUBS_PER_THREAD);
+    if (job.num_subs > n) job.num_subs = n;
+    job.sub_len = n / job.num_subs;
+    parallel_for(fft_g1_sub_task, &job, job.num_subs, num_threads);
+
+    for (job.half = job.sub_len; job.half < n; job.half *= 2) {
+        job.num_k = out_len < job.half ? out_len : job.half;
+        fft_g1_stage_twiddles(&job.w, fs, inverse, job.half);
+        parallel_for(fft_g1_butterfly_task, &job, n / (2 * job.half) * job.num_k, num_threads);
+    }
+}
+
+/**
+ * Fast Fourier Transform, with optional scaling of the inputs and outputs.
+ *
+ * The input factors are applied at the leaves of the recursion. The output factors are combined with @p scale into a
+ * single multiplication of each output.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data (array of length @p in_len)
+ * @param[in]  in_len  The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      The FFT settings, with `max_width` at least @p n
+ * @param[in]  pre     Factors to multiply the inputs by (array of length @p in_len), or `NULL`
+ * @param[in]  scale   A factor to multiply all the outputs by, or `NULL`
+ * @param[in]  post    Factors to multiply the outputs by (array of length @p out_len), or `NULL`. Requires @p scale.
+ */
+static void fft_g1_scaled(g1_t *out, const g1_t *in, uint64_t in_len, uint64_t out_len, bool inverse, uint64_t n,
+                          const FFTSettings *fs, const fr_t *pre, const fr_t *scale, const fr_t *post) {
+    int num_threads = n >= FFT_G1_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    if (num_threads > 1) {
+        fft_g1_parallel(out, in, pre, in_len, out_len, inverse, n, fs, num_threads);
+    } else {
+        fft_g1_stages(out, in, pre, 1, in_len, out_len, inverse, n, fs);
+    }
+    if (scale != NULL) {
+        fft_g1_job job = {.out = out, .scale = scale, .post = post};
+        parallel_for(fft_g1_scale_task, &job, out_len, num_threads);
+    }
+}
+
+static void fft_g1_dif_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    fft_g1_job *job = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        uint64_t k = i % job->num_k, j = (i / job->num_k) * 2 * job->half;
+        g1_t tmp, *a = &job->out[j + k], *b = &job->out[j + k + job->half];
+        if (k + job->half < job->in_len) {
+            g1_sub(&tmp, a, b);
+            g1_add_or_dbl(a, a, b);
+        } else {
+            // The other input is known to be the identity
+            tmp = *a;
+        }
+        if (k == 0) {
+            *b = tmp;
+        } else {
+            fft_g1_mul_twiddle(b, &tmp, &job->w, k);
+        }
+    }
+}
+
+/**
+ * Fast Fourier Transform from natural order to bit-reversed order, without permuting the data.
+ *
+ * Decimation in frequency, level by level from the whole array down, with the butterflies of each level shared
+ * between the threads. Inputs beyond the first @p in_len are taken as the identity and are not read. While the
+ * non-identity inputs fit in the top half of each sub-transform, its butterflies reduce to a single multiplication.
+ *
+ * @param[out] out     The results, in bit-reversed order (array of length @p n)
+ * @param[in]  in      The input data (array of length @p in_len), which may be the same as @p out
+ * @param[in]  in_len  The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      The FFT settings, with `max_width` at least @p n
+ * @param[in]  scale   A factor to multiply all the inputs by, or `NULL`
+ */
+static void fft_g1_dif_scaled(g1_t *out, const g1_t *in, uint64_t in_len, bool inverse, uint64_t n,
+                              const FFTSettings *fs, const fr_t *scale) {
+    int num_threads = n >= FFT_G1_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    fft_g1_job job = {.out = out, .in_len = in_len, .scale = scale, .inverse = inverse, .fs = fs};
+
+    if (in_len == 0) {
+        for (uint64_t i = 0; i < n; i++) {
+            out[i] = g1_identity;
+        }
+        return;
+    }
+    if (in != out) {
+        for (uint64_t i = 0; i < in_len; i++) {
+            out[i] = in[i];
+        }
+    }
+    if (scale != NULL) parallel_for(fft_g1_scale_task, &job, in_len, num_threads);
+
+    // Each level leaves the non-identity values in the first `min(in_len, half)` of each sub-transform
+    for (job.half = n / 2; job.half >= 1; job.half /= 2) {
+        job.num_k = job.in_len < job.half ? job.in_len : job.half;
+        fft_g1_stage_twiddles(&job.w, fs, inverse, job.half);
+        parallel_for(fft_g1_dif_task, &job, n / (2 * job.half) * job.num_k, num_threads);
+        job.in_len = job.num_k;
+    }
+}
+
+/**
+ * Fast Fourier Transform from bit-reversed order to natural order, without permuting the data.
+ *
+ * Decimation in time, level by level, with the butterflies of each level shared between the threads. Only the first
+ * @p out_len outputs are computed, as in #fft_g1_parallel.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data, in bit-reversed order (array of length @p n), which may be the same as @p out
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      The FFT settings, with `max_width` at least @p n
+ * @param[in]  scale   A factor to multiply all the outputs by, or `NULL`
+ */
+static void fft_g1_dit_scaled(g1_t *out, const g1_t *in, uint64_t out_len, bool inverse, uint64_t n,
+                              const FFTSettings *fs, const fr_t *scale) {
+    int num_threads = n >= FFT_G1_PARALLEL_MIN_LEN ? fs->num_threads : 1;
+    fft_g1_job job = {.out = out, .out_len = out_len, .scale = scale, .inverse = inverse, .fs = fs};
+
+    if (in != out) {
+        for (uint64_t i = 0; i < n; i++) {
+            out[i] = in[i];
+        }
+    }
+    for (job.half = 1; job.half < n; job.half *= 2) {
+        job.num_k = out_len < job.half ? out_len : job.half;
+        fft_g1_stage_twiddles(&job.w, fs, inverse, job.half);
+        parallel_for(fft_g1_butterfly_task, &job, n / (2 * job.half) * job.num_k, num_threads);
+    }
+    if (scale != NULL) parallel_for(fft_g1_scale_task, &job, out_len, num_threads);
+}
+
 /**
  * The main entry point for forward and reverse FFTs over the finite field.
  *
+ * Large transforms are spread over `fs->num_threads` threads.
+ *
  * @param[out] out     The results (array of length @p n)
  * @param[in]  in      The input data (array of length @p n)
  * @param[in]  inverse `false` for forward transform, `true` for inverse transform
@@ -96,19 +437,259 @@ void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots,
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  */
 C_KZG_RET fft_g1(g1_t *out, const g1_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
-    uint64_t stride = fs->max_width / n;
     CHECK(n <= fs->max_width);
     CHECK(is_power_of_two(n));
     if (inverse) {
         fr_t inv_len;
         fr_from_uint64(&inv_len, n);
         fr_inv(&inv_len, &inv_len);
-        fft_g1_fast(out, in, 1, fs->reverse_roots_of_unity, stride, n);
-        for (uint64_t i = 0; i < n; i++) {
-            g1_mul(&out[i], &out[i], &inv_len);
-        }
+        fft_g1_scaled(out, in, n, n, true, n, fs, NULL, &inv_len, NULL);
     } else {
-        fft_g1_fast(out, in, 1, fs->expanded_roots_of_unity, stride, n);
+        fft_g1_scaled(out, in, n, n, false, n, fs, NULL, NULL, NULL);
     }
     return C_KZG_OK;
 }
+
+/**
+ * Forward and reverse FFTs of G1 group elements over a coset of the roots of unity.
+ *
+ * As #fft_fr_coset. The forward transform multiplies the `i`th input by `shift^i` as it is read, and the inverse
+ * transform combines `shift^-i` with the `1 / n` scaling of the `i`th output, so neither needs its own pass over the
+ * points.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  shift   The coset shift, which must not be zero
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET fft_g1_coset(g1_t *out, const g1_t *in, bool inverse, uint64_t n, const fr_t *shift,
+                       const FFTSettings *fs) {
+    const fr_t *powers;
+    fr_t *tmp;
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(!fr_is_zero(shift));
+    TRY(coset_shift_powers(&powers, &tmp, fs, shift, inverse, n));
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_g1_scaled(out, in, n, n, true, n, fs, NULL, &inv_len, powers);
+    } else {
+        fft_g1_scaled(out, in, n, n, false, n, fs, powers, NULL, NULL);
+    }
+    free(tmp);
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs of G1 group elements that are known to be the identity beyond the first @p in_len,
+ * computing only the first @p out_len results.
+ *
+ * As #fft_fr_pruned. This is the same as padding the input to length @p n with the identity for #fft_g1 and
+ * discarding all but the first @p out_len outputs, but skips the group operations that depend only on the padding or
+ * contribute only to the discarded outputs.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data (array of length @p in_len)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  in_len  The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in must not overlap.
+ */
+C_KZG_RET fft_g1_pruned(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t in_len, uint64_t out_len,
+                        const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(in_len <= n);
+    CHECK(out_len <= n);
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_g1_scaled(out, in, in_len, out_len, true, n, fs, NULL, &inv_len, NULL);
+    } else {
+        fft_g1_scaled(out, in, in_len, out_len, false, n, fs, NULL, NULL, NULL);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs of G1 group elements that take natural order to bit-reversed order, without permuting the
+ * data.
+ *
+ * As #fft_fr_dif, for input that is the identity beyond its first @p in_len elements. See #fft_g1_dif_scaled.
+ *
+ * @param[out] out     The results, in bit-reversed order (array of length @p n)
+ * @param[in]  in      The input data (array of length @p in_len)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  in_len  The number of inputs, the rest being the identity, at most @p n
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_g1_dif(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t in_len, const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(in_len <= n);
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_g1_dif_scaled(out, in, in_len, true, n, fs, &inv_len);
+    } else {
+        fft_g1_dif_scaled(out, in, in_len, false, n, fs, NULL);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * Forward and reverse FFTs of G1 group elements that take bit-reversed order to natural order, without permuting the
+ * data.
+ *
+ * As #fft_fr_dit, computing only the first @p out_len results. See #fft_g1_dit_scaled.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data, in bit-reversed order (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_g1_dit(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t out_len, const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(out_len <= n);
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        fft_g1_dit_scaled(out, in, out_len, true, n, fs, &inv_len);
+    } else {
+        fft_g1_dit_scaled(out, in, out_len, false, n, fs, NULL);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * As #fft_g1_dit, but without the scaling by `1 / n` of the inverse transform.
+ *
+ * The scaling is a full scalar multiplication of every output. Callers that multiply the input by field elements
+ * anyway can fold `1 / n` into those instead, and skip the pass altogether.
+ *
+ * @param[out] out     The first @p out_len results (array of length @p n, all of which may be written)
+ * @param[in]  in      The input data, in bit-reversed order (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for the unscaled inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  out_len The number of outputs wanted, at most @p n
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ *
+ * @remark @p out and @p in may be the same array.
+ */
+C_KZG_RET fft_g1_dit_unnormalised(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t out_len,
+                                  const FFTSettings *fs) {
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(out_len <= n);
+    fft_g1_dit_scaled(out, in, out_len, inverse, n, fs, NULL);
+    return C_KZG_OK;
+}
+
+/**
+ * Fast Fourier Transform on affine G1 points.
+ *
+ * Iterative, working level by level so that the additions of each level can be done together in affine coordinates
+ * with a single shared field inversion, see #g1_affine_butterfly_pass. The twiddle multiplications of each level are
+ * done in projective coordinates and converted back to affine in one batch.
+ *
+ * @param[out] out     The results (array of length @p n)
+ * @param[in]  in      The input data (array of length @p n)
+ * @param[in]  inverse `false` for forward transform, `true` for inverse transform
+ * @param[in]  n       Length of the FFT, must be a power of two
+ * @param[in]  fs      Pointer to previously initialised FFTSettings structure with `max_width` at least @p n.
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ *
+ * @remark @p out and @p in may not be the same array.
+ */
+C_KZG_RET fft_g1_affine(g1_affine_t *out, const g1_affine_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
+    g1_t *tmp;
+    g1_affine_t *tmp_affine;
+    CHECK(n <= fs->max_width);
+    CHECK(is_power_of_two(n));
+    CHECK(n >> 32 == 0);
+
+    if (n == 1) {
+        out[0] = in[0];
+        return C_KZG_OK;
+    }
+
+    TRY(new_g1_array(&tmp, n / 2));
+    if (new_g1_affine_array(&tmp_affine, n / 2) != C_KZG_OK) {
+        free(tmp);
+        return C_KZG_MALLOC;
+    }
+
+    int unused_bit_len = 32 - log2_pow2(n);
+    for (uint64_t i = 0; i < n; i++) {
+        out[reverse_bits(i) >> unused_bit_len] = in[i];
+    }
+
+    for (uint64_t h = 1; h < n; h *= 2) {
+        fft_g1_twiddles w;
+        fft_g1_stage_twiddles(&w, fs, inverse, h);
+
+        // Apply the twiddles to the second point of each pair. The first twiddle of each block is one.
+        if (h > 1) {
+            for (uint64_t i = 0; i < n / 2; i++) {
+                uint64_t k = i & (h - 1), j = (i - k) * 2;
+                g1_from_affine(&tmp[i], &out[j + k + h]);
+                if (k > 0) fft_g1_mul_twiddle(&tmp[i], &tmp[i], &w, k);
+            }
+            g1_to_affine(tmp_affine, tmp, n / 2);
+            for (uint64_t i = 0; i < n / 2; i++) {
+                uint64_t k = i & (h - 1), j = (i - k) * 2;
+                out[j + k + h] = tmp_affine[i];
+            }
+        }
+
+        g1_affine_butterfly_pass(out, n, h);
+    }
+
+    if (inverse) {
+        fr_t inv_len;
+        fr_from_uint64(&inv_len, n);
+        fr_inv(&inv_len, &inv_len);
+        for (uint64_t j = 0; j < n; j += n / 2) {
+            for (uint64_t i = 0; i < n / 2; i++) {
+                g1_from_affine(&tmp[i], &out[j + i]);
+                g1_mul(&tmp[i], &tmp[i], &inv_len);
+            }
+            g1_to_affine(&out[j], tmp, n / 2);
+        }
+    }
+
+    free(tmp_affine);
+    free(tmp);
+    return C_KZG_OK;
+}
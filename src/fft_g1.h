@@ -21,3 +21,12 @@
 void fft_g1_slow(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots, uint64_t roots_stride, uint64_t n);
 void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots, uint64_t roots_stride, uint64_t n);
 C_KZG_RET fft_g1(g1_t *out, const g1_t *in, bool inverse, uint64_t n, const FFTSettings *fs);
+C_KZG_RET fft_g1_coset(g1_t *out, const g1_t *in, bool inverse, uint64_t n, const fr_t *shift,
+                       const FFTSettings *fs);
+C_KZG_RET fft_g1_pruned(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t in_len, uint64_t out_len,
+                        const FFTSettings *fs);
+C_KZG_RET fft_g1_dif(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t in_len, const FFTSettings *fs);
+C_KZG_RET fft_g1_dit(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t out_len, const FFTSettings *fs);
+C_KZG_RET fft_g1_dit_unnormalised(g1_t *out, const g1_t *in, bool inverse, uint64_t n, uint64_t out_len,
+                                  const FFTSettings *fs);
+C_KZG_RET fft_g1_affine(g1_affine_t *out, const g1_affine_t *in, bool inverse, uint64_t n, const FFTSettings *fs);
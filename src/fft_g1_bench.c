@@ -22,13 +22,15 @@
 #include "test_util.h"
 #include "fft_g1.h"
 
-// Run the benchmark for `max_seconds` and return the time per iteration in nanoseconds.
-long run_bench(int scale, int max_seconds) {
+// Run the benchmark for `max_seconds` and return the time per iteration in nanoseconds. With `recoded` the twiddle
+// factors are recoded in advance.
+long run_bench(int scale, int max_seconds, bool recoded) {
     timespec_t t0, t1;
     unsigned long total_time = 0, nits = 0;
     FFTSettings fs;
 
     assert(C_KZG_OK == new_fft_settings(&fs, scale));
+    if (recoded) assert(C_KZG_OK == precompute_fft_recodings(&fs));
 
     // Allocate on the heap to avoid stack overflow for large sizes
     g1_t *data, *out;
@@ -55,6 +57,41 @@ long run_bench(int scale, int max_seconds) {
     return total_time / nits;
 }
 
+// As run_bench(), but for the affine version with batched inversions.
+long run_bench_affine(int scale, int max_seconds) {
+    timespec_t t0, t1;
+    unsigned long total_time = 0, nits = 0;
+    FFTSettings fs;
+
+    assert(C_KZG_OK == new_fft_settings(&fs, scale));
+
+    g1_t *points;
+    g1_affine_t *data, *out;
+    points = malloc(fs.max_width * sizeof(g1_t));
+    data = malloc(fs.max_width * sizeof(g1_affine_t));
+    out = malloc(fs.max_width * sizeof(g1_affine_t));
+
+    for (uint64_t i = 0; i < fs.max_width; i++) {
+        points[i] = rand_g1();
+    }
+    g1_to_affine(data, points, fs.max_width);
+
+    while (total_time < max_seconds * NANO) {
+        clock_gettime(CLOCK_REALTIME, &t0);
+        assert(C_KZG_OK == fft_g1_affine(out, data, false, fs.max_width, &fs));
+        clock_gettime(CLOCK_REALTIME, &t1);
+        nits++;
+        total_time += tdiff(t0, t1);
+    }
+
+    free(out);
+    free(data);
+    free(points);
+    free_fft_settings(&fs);
+
+    return total_time / nits;
+}
+
 int main(int argc, char *argv[]) {
     int nsec = 0;
 
@@ -75,8 +112,12 @@ int main(int argc, char *argv[]) {
     }
 
     printf("*** Benchmarking FFT_g1, %d second%s per test.\n", nsec, nsec == 1 ? "" : "s");
-    for (int scale = 4; scale <= 15; scale++) {
-        printf("fft_g1/scale_%d %lu ns/op\n", scale, run_bench(scale, nsec));
+    for (int scale = 4; scale <= 16; scale++) {
+        printf("fft_g1/scale_%d %lu ns/op\n", scale, run_bench(scale, nsec, false));
+        printf("fft_g1_recoded/scale_%d %lu ns/op\n", scale, run_bench(scale, nsec, true));
+        if (scale >= 10) {
+            printf("fft_g1_affine/scale_%d %lu ns/op\n", scale, run_bench_affine(scale, nsec));
+        }
     }
 
     return EXIT_SUCCESS;
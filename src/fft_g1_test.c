@@ -17,6 +17,7 @@
 #include "../inc/acutest.h"
 #include "test_util.h"
 #include "fft_g1.h"
+#include "utility.h"
 
 void make_data(g1_t *out, uint64_t n) {
     // Multiples of g1_gen
@@ -33,10 +34,14 @@ void compare_sft_fft(void) {
     FFTSettings fs;
     TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
     g1_t data[fs.max_width], slow[fs.max_width], fast[fs.max_width];
+    fr_t roots[fs.max_width + 1];
     make_data(data, fs.max_width);
 
+    // The slow transform needs all the roots, not just the first half in the settings
+    TEST_CHECK(expand_root_of_unity(roots, &fs.root_of_unity, fs.max_width) == C_KZG_OK);
+
     // Do both fast and slow transforms
-    fft_g1_slow(slow, data, 1, fs.expanded_roots_of_unity, 1, fs.max_width);
+    fft_g1_slow(slow, data, 1, roots, 1, fs.max_width);
     fft_g1_fast(fast, data, 1, fs.expanded_roots_of_unity, 1, fs.max_width);
 
     // Verify the results are identical
@@ -88,10 +93,277 @@ void stride_fft(void) {
     free_fft_settings(&fs2);
 }
 
+void stage_roots_fft(void) {
+    unsigned int size = 8;
+    uint64_t width = (uint64_t)1 << 6;
+    FFTSettings fs1, fs2;
+    TEST_CHECK(new_fft_settings(&fs1, size) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings(&fs2, size) == C_KZG_OK);
+    TEST_CHECK(precompute_fft_settings(&fs2) == C_KZG_OK);
+    g1_t data[width], coeffs1[width], coeffs2[width];
+    make_data(data, width);
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        TEST_CHECK(fft_g1(coeffs1, data, inverse, width, &fs1) == C_KZG_OK);
+        TEST_CHECK(fft_g1(coeffs2, data, inverse, width, &fs2) == C_KZG_OK);
+        for (int i = 0; i < width; i++) {
+            TEST_CHECK(g1_equal(coeffs1 + i, coeffs2 + i));
+        }
+    }
+
+    free_fft_settings(&fs1);
+    free_fft_settings(&fs2);
+}
+
+void recoded_fft(void) {
+    unsigned int size = 8;
+    uint64_t width = (uint64_t)1 << 6;
+    FFTSettings fs1, fs2;
+    TEST_CHECK(new_fft_settings(&fs1, size) == C_KZG_OK);
+    TEST_CHECK(new_fft_settings(&fs2, size) == C_KZG_OK);
+    TEST_CHECK(precompute_fft_recodings(&fs2) == C_KZG_OK);
+    g1_t data[width], coeffs1[width], coeffs2[width];
+    make_data(data, width);
+
+    // Recursive, parallel and bit-reversed transforms all take their twiddles from the recodings
+    for (int num_threads = 1; num_threads <= 3; num_threads += 2) {
+        fs1.num_threads = fs2.num_threads = num_threads;
+        for (int inverse = 0; inverse < 2; inverse++) {
+            TEST_CHECK(fft_g1(coeffs1, data, inverse, width, &fs1) == C_KZG_OK);
+            TEST_CHECK(fft_g1(coeffs2, data, inverse, width, &fs2) == C_KZG_OK);
+            for (int i = 0; i < width; i++) {
+                TEST_CHECK(g1_equal(coeffs1 + i, coeffs2 + i));
+            }
+            TEST_CHECK(fft_g1_dif(coeffs1, data, inverse, width, width, &fs1) == C_KZG_OK);
+            TEST_CHECK(fft_g1_dif(coeffs2, data, inverse, width, width, &fs2) == C_KZG_OK);
+            for (int i = 0; i < width; i++) {
+                TEST_CHECK(g1_equal(coeffs1 + i, coeffs2 + i));
+            }
+        }
+    }
+
+    free_fft_settings(&fs1);
+    free_fft_settings(&fs2);
+}
+
+void parallel_fft(void) {
+    unsigned int size = 8;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], coeffs1[fs.max_width], coeffs2[fs.max_width];
+    make_data(data, fs.max_width);
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        fs.num_threads = 1;
+        TEST_CHECK(fft_g1(coeffs1, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        fs.num_threads = 3;
+        TEST_CHECK(fft_g1(coeffs2, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        for (int i = 0; i < fs.max_width; i++) {
+            TEST_CHECK(g1_equal(coeffs1 + i, coeffs2 + i));
+        }
+        // A count below one means one thread
+        fs.num_threads = -1;
+        TEST_CHECK(fft_g1(coeffs2, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        for (int i = 0; i < fs.max_width; i++) {
+            TEST_CHECK(g1_equal(coeffs1 + i, coeffs2 + i));
+        }
+    }
+
+    free_fft_settings(&fs);
+}
+
+void affine_fft(void) {
+    unsigned int size = 6;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], expected[fs.max_width], res[fs.max_width];
+    g1_affine_t data_affine[fs.max_width], out[fs.max_width];
+    make_data(data, fs.max_width);
+
+    // Identities and repeated points exercise the projective fallback of the affine butterflies
+    data[3] = g1_identity;
+    data[4] = data[5];
+    g1_to_affine(data_affine, data, fs.max_width);
+
+    for (int inverse = 0; inverse < 2; inverse++) {
+        TEST_CHECK(fft_g1(expected, data, inverse, fs.max_width, &fs) == C_KZG_OK);
+        TEST_CHECK(fft_g1_affine(out, data_affine, inverse, fs.max_width, &fs) == C_KZG_OK);
+        for (int i = 0; i < fs.max_width; i++) {
+            g1_from_affine(&res[i], &out[i]);
+            TEST_CHECK(g1_equal(&expected[i], &res[i]));
+        }
+    }
+
+    // All points the same: every butterfly of the first level is a doubling or cancels
+    for (int i = 0; i < fs.max_width; i++) {
+        data[i] = g1_generator;
+    }
+    g1_to_affine(data_affine, data, fs.max_width);
+    TEST_CHECK(fft_g1(expected, data, false, fs.max_width, &fs) == C_KZG_OK);
+    TEST_CHECK(fft_g1_affine(out, data_affine, false, fs.max_width, &fs) == C_KZG_OK);
+    for (int i = 0; i < fs.max_width; i++) {
+        g1_from_affine(&res[i], &out[i]);
+        TEST_CHECK(g1_equal(&expected[i], &res[i]));
+    }
+
+    free_fft_settings(&fs);
+}
+
+void coset_fft(void) {
+    unsigned int size = 7;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], scaled[fs.max_width], expected[fs.max_width], out[fs.max_width];
+    fr_t shift, inv_shift, power;
+    fr_from_uint64(&shift, 7);
+    fr_inv(&inv_shift, &shift);
+    make_data(data, fs.max_width);
+
+    for (int cached = 0; cached < 2; cached++) {
+        if (cached) TEST_CHECK(precompute_fft_coset(&fs, &shift) == C_KZG_OK);
+        for (int num_threads = 1; num_threads <= 3; num_threads += 2) {
+            fs.num_threads = num_threads;
+
+            power = fr_one;
+            for (int i = 0; i < fs.max_width; i++) {
+                g1_mul(&scaled[i], &data[i], &power);
+                fr_mul(&power, &power, &shift);
+            }
+            TEST_CHECK(fft_g1(expected, scaled, false, fs.max_width, &fs) == C_KZG_OK);
+            TEST_CHECK(fft_g1_coset(out, data, false, fs.max_width, &shift, &fs) == C_KZG_OK);
+            for (int i = 0; i < fs.max_width; i++) {
+                TEST_CHECK(g1_equal(&expected[i], &out[i]));
+            }
+
+            TEST_CHECK(fft_g1(expected, data, true, fs.max_width, &fs) == C_KZG_OK);
+            power = fr_one;
+            for (int i = 0; i < fs.max_width; i++) {
+                g1_mul(&expected[i], &expected[i], &power);
+                fr_mul(&power, &power, &inv_shift);
+            }
+            TEST_CHECK(fft_g1_coset(out, data, true, fs.max_width, &shift, &fs) == C_KZG_OK);
+            for (int i = 0; i < fs.max_width; i++) {
+                TEST_CHECK(g1_equal(&expected[i], &out[i]));
+            }
+        }
+    }
+
+    free_fft_settings(&fs);
+}
+
+void pruned_fft(void) {
+    unsigned int size = 7;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], expected[fs.max_width], out[fs.max_width];
+    make_data(data, fs.max_width);
+
+    // Compare against transforms padded with the identity, both whole and split over threads
+    for (int num_threads = 1; num_threads <= 3; num_threads += 2) {
+        fs.num_threads = num_threads;
+        for (uint64_t n = 1; n <= fs.max_width; n *= 8) {
+            const uint64_t lens[] = {0, 1, 3, n / 2, n};
+            for (int a = 0; a < 5; a++) {
+                uint64_t in_len = lens[a] < n ? lens[a] : n;
+                g1_t padded[n];
+                for (uint64_t i = 0; i < n; i++) {
+                    padded[i] = i < in_len ? data[i] : g1_identity;
+                }
+                for (int inverse = 0; inverse < 2; inverse++) {
+                    TEST_CHECK(fft_g1(expected, padded, inverse, n, &fs) == C_KZG_OK);
+                    for (int b = 0; b < 5; b++) {
+                        uint64_t out_len = lens[b] < n ? lens[b] : n;
+                        TEST_CHECK(fft_g1_pruned(out, data, inverse, n, in_len, out_len, &fs) == C_KZG_OK);
+                        for (uint64_t i = 0; i < out_len; i++) {
+                            TEST_CHECK(g1_equal(&expected[i], &out[i]));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(fft_g1_pruned(out, data, false, 8, 9, 8, &fs) == C_KZG_BADARGS);
+    TEST_CHECK(fft_g1_pruned(out, data, false, 8, 8, 9, &fs) == C_KZG_BADARGS);
+
+    free_fft_settings(&fs);
+}
+
+void dif_dit_fft(void) {
+    unsigned int size = 7;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], expected[fs.max_width], out[fs.max_width];
+    make_data(data, fs.max_width);
+
+    for (int num_threads = 1; num_threads <= 3; num_threads += 2) {
+        fs.num_threads = num_threads;
+        for (uint64_t n = 1; n <= fs.max_width; n *= 8) {
+            const uint64_t lens[] = {0, 1, 3, n / 2, n};
+            for (int a = 0; a < 5; a++) {
+                uint64_t len = lens[a] < n ? lens[a] : n;
+                g1_t padded[n];
+                for (uint64_t i = 0; i < n; i++) {
+                    padded[i] = i < len ? data[i] : g1_identity;
+                }
+                for (int inverse = 0; inverse < 2; inverse++) {
+                    // DIF of inputs padded with the identity gives the bit-reversed result
+                    TEST_CHECK(fft_g1(expected, padded, inverse, n, &fs) == C_KZG_OK);
+                    TEST_CHECK(fft_g1_dif(out, data, inverse, n, len, &fs) == C_KZG_OK);
+                    for (uint64_t i = 0; i < n; i++) {
+                        TEST_CHECK(g1_equal(&expected[reverse_bits_limited(n, i)], &out[i]));
+                    }
+
+                    // DIT, in place, takes it back as far as asked
+                    TEST_CHECK(fft_g1_dit(out, out, !inverse, n, len, &fs) == C_KZG_OK);
+                    for (uint64_t i = 0; i < len; i++) {
+                        TEST_CHECK(g1_equal(&data[i], &out[i]));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(fft_g1_dif(out, data, false, 8, 9, &fs) == C_KZG_BADARGS);
+    TEST_CHECK(fft_g1_dit(out, data, false, 8, 9, &fs) == C_KZG_BADARGS);
+
+    free_fft_settings(&fs);
+}
+
+void unnormalised_fft(void) {
+    unsigned int size = 6;
+    FFTSettings fs;
+    TEST_CHECK(new_fft_settings(&fs, size) == C_KZG_OK);
+    g1_t data[fs.max_width], out[fs.max_width], expected;
+    fr_t len;
+    make_data(data, fs.max_width);
+    fr_from_uint64(&len, fs.max_width);
+
+    // The round trip leaves the data multiplied by the length
+    TEST_CHECK(fft_g1_dif(out, data, false, fs.max_width, fs.max_width, &fs) == C_KZG_OK);
+    TEST_CHECK(fft_g1_dit_unnormalised(out, out, true, fs.max_width, fs.max_width, &fs) == C_KZG_OK);
+    for (uint64_t i = 0; i < fs.max_width; i++) {
+        g1_mul(&expected, &data[i], &len);
+        TEST_CHECK(g1_equal(&expected, &out[i]));
+    }
+
+    TEST_CHECK(fft_g1_dit_unnormalised(out, data, true, 8, 9, &fs) == C_KZG_BADARGS);
+
+    free_fft_settings(&fs);
+}
+
 TEST_LIST = {
     {"FFT_G1_TEST", title},
     {"compare_sft_fft", compare_sft_fft},
     {"roundtrip_fft", roundtrip_fft},
     {"stride_fft", stride_fft},
+    {"stage_roots_fft", stage_roots_fft},
+    {"recoded_fft", recoded_fft},
+    {"parallel_fft", parallel_fft},
+    {"affine_fft", affine_fft},
+    {"coset_fft", coset_fft},
+    {"pruned_fft", pruned_fft},
+    {"dif_dit_fft", dif_dit_fft},
+    {"unnormalised_fft", unnormalised_fft},
     {NULL, NULL} /* zero record marks the end of the list */
 };
@@ -32,54 +32,52 @@
  * The first part of the Toeplitz matrix multiplication algorithm: the Fourier
  * transform of the vector @p x extended.
  *
- * @param[out] out The FFT of the extension of @p x, size @p n * 2
+ * The extension is @p x padded to twice its length with the identity, which the transform skips rather than reads.
+ * The result is left in bit-reversed order, which saves permuting it here and again in #toeplitz_part_3.
+ *
+ * @param[out] out The FFT of the extension of @p x in bit-reversed order, size @p n * 2
  * @param[in]  x   The input vector, size @p n
  * @param[in]  n   The length of the input vector @p x
  * @param[in]  fs  The FFT settings previously initialised with #new_fft_settings
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_ERROR   An internal error occurred
- * @retval C_CZK_MALLOC  Memory allocation failed
  */
 C_KZG_RET toeplitz_part_1(g1_t *out, const g1_t *x, uint64_t n, const FFTSettings *fs) {
-    uint64_t n2 = n * 2;
-    g1_t *x_ext;
-
-    TRY(new_g1_array(&x_ext, n2));
-    for (uint64_t i = 0; i < n; i++) {
-        x_ext[i] = x[i];
-    }
-    for (uint64_t i = n; i < n2; i++) {
-        x_ext[i] = g1_identity;
-    }
-
-    TRY(fft_g1(out, x_ext, false, n2, fs));
-
-    free(x_ext);
+    TRY(fft_g1_dif(out, x, false, n * 2, n, fs));
     return C_KZG_OK;
 }
 
 /**
  * The second part of the Toeplitz matrix multiplication algorithm.
  *
- * @param[out] out Array of G1 group elements, length `n`
+ * The pointwise product is formed in bit-reversed order, matching #toeplitz_part_1. It is also scaled by `1 / n`,
+ * which is cheap on the field elements, so that #toeplitz_part_3 can skip normalising its inverse transform.
+ *
+ * @param[out] out Array of G1 group elements in bit-reversed order, scaled by `1 / n`, length `n`
  * @param[in]  toeplitz_coeffs Toeplitz coefficients, a polynomial length `n`
- * @param[in]  x_ext_fft The Fourier transform of the extended `x` vector, length `n`
+ * @param[in]  x_ext_fft The Fourier transform of the extended `x` vector in affine coordinates and bit-reversed order,
+ * length `n`
  * @param[in]  fs  The FFT settings previously initialised with #new_fft_settings
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  * @retval C_CZK_ERROR   An internal error occurred
  * @retval C_CZK_MALLOC  Memory allocation failed
  */
-C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_t *x_ext_fft, const FFTSettings *fs) {
-    fr_t *toeplitz_coeffs_fft;
+C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_affine_t *x_ext_fft,
+                          const FFTSettings *fs) {
+    fr_t *toeplitz_coeffs_fft, inv_len;
 
     // CHECK(toeplitz_coeffs->length == fk->x_ext_fft_len); // TODO: how to implement?
 
     TRY(new_fr_array(&toeplitz_coeffs_fft, toeplitz_coeffs->length));
-    TRY(fft_fr(toeplitz_coeffs_fft, toeplitz_coeffs->coeffs, false, toeplitz_coeffs->length, fs));
+    TRY(fft_fr_dif(toeplitz_coeffs_fft, toeplitz_coeffs->coeffs, false, toeplitz_coeffs->length, NULL, fs));
+    fr_from_uint64(&inv_len, toeplitz_coeffs->length);
+    fr_inv(&inv_len, &inv_len);
+    fr_vec_scale(toeplitz_coeffs_fft, toeplitz_coeffs_fft, &inv_len, toeplitz_coeffs->length);
 
     for (uint64_t i = 0; i < toeplitz_coeffs->length; i++) {
-        g1_mul(&out[i], &x_ext_fft[i], &toeplitz_coeffs_fft[i]);
+        g1_from_affine(&out[i], &x_ext_fft[i]);
+        g1_mul(&out[i], &out[i], &toeplitz_coeffs_fft[i]);
     }
 
     free(toeplitz_coeffs_fft);
@@ -89,8 +87,10 @@ C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_t *x_
 /**
  * The third part of the Toeplitz matrix multiplication algorithm: transform back and zero the top half.
  *
+ * The inverse transform is not normalised, as #toeplitz_part_2 has already scaled its input by `1 / n2`.
+ *
  * @param[out] out Array of G1 group elements, length @p n2
- * @param[in]  h_ext_fft FFT of the extended `h` values, length @p n2
+ * @param[in]  h_ext_fft FFT of the extended `h` values in bit-reversed order, scaled by `1 / n2`, length @p n2
  * @param[in]  n2  Size of the arrays
  * @param[in]  fs  The FFT settings previously initialised with #new_fft_settings
  * @retval C_CZK_OK      All is well
@@ -99,7 +99,8 @@ C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_t *x_
 C_KZG_RET toeplitz_part_3(g1_t *out, const g1_t *h_ext_fft, uint64_t n2, const FFTSettings *fs) {
     uint64_t n = n2 / 2;
 
-    TRY(fft_g1(out, h_ext_fft, true, n2, fs));
+    // Only the bottom half of the inverse transform is kept
+    TRY(fft_g1_dit_unnormalised(out, h_ext_fft, true, n2, n, fs));
 
     // Zero the second half of h
     for (uint64_t i = n; i < n2; i++) {
@@ -156,32 +157,21 @@ C_KZG_RET toeplitz_coeffs_step(poly *out, const poly *in) {
 }
 
 /**
- * Optimised version of the FK20 algorithm for use in data availability checks.
+ * The FK20 single algorithm for data availability, with the proofs in either order.
  *
- * Simultaneously calculates all the KZG proofs for `x_i = w^i` (`0 <= i < 2n`), where `w` is a `(2 * n)`th root of
- * unity. The `2n` comes from the polynomial being extended with zeros to twice the original size.
- *
- * `out[i]` is the proof for `y[i]`, the evaluation of the polynomial at `fs.expanded_roots_of_unity[i]`.
- *
- * @remark Only the lower half of the polynomial is supplied; the upper, zero, half is assumed. The
- * #toeplitz_coeffs_step routine does the right thing.
- *
- * @param[out] out Array size `n * 2`
+ * @param[out] out The proofs, array size `n * 2`, in bit-reversed order if @p bit_reversed is `true`
  * @param[in]  p   Polynomial, size `n`
  * @param[in]  fk  FK20 single settings previously initialised by #new_fk20_single_settings
+ * @param[in]  bit_reversed `false` for the proofs in natural order, `true` for bit-reversed order
  * @retval C_CZK_OK      All is well
- * @retval C_CZK_BADARGS Invalid parameters were supplied
  * @retval C_CZK_ERROR   An internal error occurred
  * @retval C_CZK_MALLOC  Memory allocation failed
  */
-C_KZG_RET fk20_single_da_opt(g1_t *out, const poly *p, const FK20SingleSettings *fk) {
+static C_KZG_RET fk20_single(g1_t *out, const poly *p, const FK20SingleSettings *fk, bool bit_reversed) {
     uint64_t n = p->length, n2 = n * 2;
     g1_t *h, *h_ext_fft;
     poly toeplitz_coeffs;
 
-    CHECK(n2 <= fk->ks->fs->max_width);
-    CHECK(is_power_of_two(n));
-
     TRY(new_poly(&toeplitz_coeffs, 2 * p->length));
     TRY(toeplitz_coeffs_step(&toeplitz_coeffs, p));
 
@@ -191,7 +181,12 @@ C_KZG_RET fk20_single_da_opt(g1_t *out, const poly *p, const FK20SingleSettings
     TRY(new_g1_array(&h, n2));
     TRY(toeplitz_part_3(h, h_ext_fft, n2, fk->ks->fs));
 
-    TRY(fft_g1(out, h, false, n2, fk->ks->fs));
+    // The top half of `h` is zero
+    if (bit_reversed) {
+        TRY(fft_g1_dif(out, h, false, n2, n, fk->ks->fs));
+    } else {
+        TRY(fft_g1_pruned(out, h, false, n2, n, n2, fk->ks->fs));
+    }
 
     free_poly(&toeplitz_coeffs);
     free(h_ext_fft);
@@ -199,14 +194,44 @@ C_KZG_RET fk20_single_da_opt(g1_t *out, const poly *p, const FK20SingleSettings
     return C_KZG_OK;
 }
 
+/**
+ * Optimised version of the FK20 algorithm for use in data availability checks.
+ *
+ * Simultaneously calculates all the KZG proofs for `x_i = w^i` (`0 <= i < 2n`), where `w` is a `(2 * n)`th root of
+ * unity. The `2n` comes from the polynomial being extended with zeros to twice the original size.
+ *
+ * `out[i]` is the proof for `y[i]`, the evaluation of the polynomial at `w^i`, see #fft_root_of_unity.
+ *
+ * @remark Only the lower half of the polynomial is supplied; the upper, zero, half is assumed. The
+ * #toeplitz_coeffs_step routine does the right thing.
+ *
+ * @param[out] out Array size `n * 2`
+ * @param[in]  p   Polynomial, size `n`
+ * @param[in]  fk  FK20 single settings previously initialised by #new_fk20_single_settings
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_ERROR   An internal error occurred
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET fk20_single_da_opt(g1_t *out, const poly *p, const FK20SingleSettings *fk) {
+    uint64_t n = p->length, n2 = n * 2;
+
+    CHECK(n2 <= fk->ks->fs->max_width);
+    CHECK(is_power_of_two(n));
+
+    TRY(fk20_single(out, p, fk, false));
+
+    return C_KZG_OK;
+}
+
 /**
  * Data availability using the FK20 single algorithm.
  *
  * Simultaneously calculates all the KZG proofs for `x_i = w^i` (`0 <= i < 2n`), where `w` is a `(2 * n)`th root of
  * unity. The `2n` comes from the polynomial being extended with zeros to twice the original size.
  *
- * `out[reverse_bits_limited(2 * n, i)]` is the proof for `y[i]`, the evaluation of the polynomial at
- * `fs.expanded_roots_of_unity[i]`.
+ * `out[reverse_bits_limited(2 * n, i)]` is the proof for `y[i]`, the evaluation of the polynomial at `w^i`, see
+ * #fft_root_of_unity.
  *
  * @param[out] out All the proofs, array length 2 * `n`
  * @param[in]  p   Polynomial, size `n`
@@ -221,8 +246,7 @@ C_KZG_RET da_using_fk20_single(g1_t *out, const poly *p, const FK20SingleSetting
     CHECK(n2 <= fk->ks->fs->max_width);
     CHECK(is_power_of_two(n));
 
-    TRY(fk20_single_da_opt(out, p, fk));
-    TRY(reverse_bit_order(out, sizeof out[0], n2));
+    TRY(fk20_single(out, p, fk, true));
 
     return C_KZG_OK;
 }
@@ -273,7 +297,8 @@ C_KZG_RET fk20_compute_proof_multi(g1_t *out, const poly *p, const FK20MultiSett
     TRY(new_g1_array(&h, n2));
     TRY(toeplitz_part_3(h, h_ext_fft, n2, fk->ks->fs));
 
-    TRY(fft_g1(out, h, false, n2, fk->ks->fs));
+    // The top half of `h` is zero
+    TRY(fft_g1_pruned(out, h, false, n2, n, n2, fk->ks->fs));
 
     free(h_ext_fft);
     free(h);
@@ -281,24 +306,19 @@ C_KZG_RET fk20_compute_proof_multi(g1_t *out, const poly *p, const FK20MultiSett
 }
 
 /**
- * FK20 multi-proof method, optimized for data availability where the top half of polynomial
- * coefficients is zero.
- *
- * @remark Only the lower half of the polynomial is supplied; the upper, zero, half is assumed. The
- * #toeplitz_coeffs_stride routine does the right thing.
+ * The FK20 multi-proof method for data availability, with the proofs in either order.
  *
- * @param[out] out The proofs, array size `2 * n / fk->chunk_length`
+ * @param[out] out The proofs, array size `2 * n / fk->chunk_length`, in bit-reversed order if @p bit_reversed is
+ * `true`
  * @param[in]  p   The polynomial, length `n`
  * @param[in]  fk  FK20 multi settings previously initialised by #new_fk20_multi_settings
+ * @param[in]  bit_reversed `false` for the proofs in natural order, `true` for bit-reversed order
  */
-C_KZG_RET fk20_multi_da_opt(g1_t *out, const poly *p, const FK20MultiSettings *fk) {
+static C_KZG_RET fk20_multi(g1_t *out, const poly *p, const FK20MultiSettings *fk, bool bit_reversed) {
     uint64_t n = p->length, n2 = n * 2, k, k2;
     g1_t *h_ext_fft, *h_ext_fft_file, *h;
     poly toeplitz_coeffs;
 
-    CHECK(n2 <= fk->ks->fs->max_width);
-    CHECK(is_power_of_two(n));
-
     n = n2 / 2;
     k = n / fk->chunk_len;
     k2 = k * 2;
@@ -329,7 +349,11 @@ C_KZG_RET fk20_multi_da_opt(g1_t *out, const poly *p, const FK20MultiSettings *f
         h[i] = g1_identity;
     }
 
-    TRY(fft_g1(out, h, false, k2, fk->ks->fs));
+    if (bit_reversed) {
+        TRY(fft_g1_dif(out, h, false, k2, k, fk->ks->fs));
+    } else {
+        TRY(fft_g1_pruned(out, h, false, k2, k, k2, fk->ks->fs));
+    }
 
     free(h_ext_fft);
     free(h);
@@ -337,6 +361,28 @@ C_KZG_RET fk20_multi_da_opt(g1_t *out, const poly *p, const FK20MultiSettings *f
     return C_KZG_OK;
 }
 
+/**
+ * FK20 multi-proof method, optimized for data availability where the top half of polynomial
+ * coefficients is zero.
+ *
+ * @remark Only the lower half of the polynomial is supplied; the upper, zero, half is assumed. The
+ * #toeplitz_coeffs_stride routine does the right thing.
+ *
+ * @param[out] out The proofs, array size `2 * n / fk->chunk_length`
+ * @param[in]  p   The polynomial, length `n`
+ * @param[in]  fk  FK20 multi settings previously initialised by #new_fk20_multi_settings
+ */
+C_KZG_RET fk20_multi_da_opt(g1_t *out, const poly *p, const FK20MultiSettings *fk) {
+    uint64_t n = p->length, n2 = n * 2;
+
+    CHECK(n2 <= fk->ks->fs->max_width);
+    CHECK(is_power_of_two(n));
+
+    TRY(fk20_multi(out, p, fk, false));
+
+    return C_KZG_OK;
+}
+
 /**
  * Computes all the KZG proofs for data availability checks.
  *
@@ -349,8 +395,7 @@ C_KZG_RET da_using_fk20_multi(g1_t *out, const poly *p, const FK20MultiSettings
     CHECK(n2 <= fk->ks->fs->max_width);
     CHECK(is_power_of_two(n));
 
-    TRY(fk20_multi_da_opt(out, p, fk));
-    TRY(reverse_bit_order(out, sizeof out[0], n2 / fk->chunk_len));
+    TRY(fk20_multi(out, p, fk, true));
 
     return C_KZG_OK;
 }
@@ -371,7 +416,7 @@ C_KZG_RET da_using_fk20_multi(g1_t *out, const poly *p, const FK20MultiSettings
  */
 C_KZG_RET new_fk20_single_settings(FK20SingleSettings *fk, uint64_t n2, const KZGSettings *ks) {
     int n = n2 / 2;
-    g1_t *x;
+    g1_t *x, *x_ext_fft;
 
     CHECK(n2 <= ks->fs->max_width);
     CHECK(is_power_of_two(n2));
@@ -382,13 +427,18 @@ C_KZG_RET new_fk20_single_settings(FK20SingleSettings *fk, uint64_t n2, const KZ
 
     TRY(new_g1_array(&x, n));
     for (uint64_t i = 0; i < n - 1; i++) {
-        x[i] = ks->secret_g1[n - 2 - i];
+        g1_from_affine(&x[i], &ks->secret_g1[n - 2 - i]);
     }
     x[n - 1] = g1_identity;
 
-    TRY(new_g1_array(&fk->x_ext_fft, 2 * n));
-    TRY(toeplitz_part_1(fk->x_ext_fft, x, n, ks->fs));
+    TRY(new_g1_array(&x_ext_fft, 2 * n));
+    TRY(toeplitz_part_1(x_ext_fft, x, n, ks->fs));
+
+    // Store the table in affine coordinates: it's smaller, and is converted once rather than on every use
+    TRY(new_g1_affine_array(&fk->x_ext_fft, 2 * n));
+    g1_to_affine(fk->x_ext_fft, x_ext_fft, 2 * n);
 
+    free(x_ext_fft);
     free(x);
     return C_KZG_OK;
 }
@@ -410,7 +460,7 @@ C_KZG_RET new_fk20_single_settings(FK20SingleSettings *fk, uint64_t n2, const KZ
  */
 C_KZG_RET new_fk20_multi_settings(FK20MultiSettings *fk, uint64_t n2, uint64_t chunk_len, const KZGSettings *ks) {
     uint64_t n, k;
-    g1_t *x;
+    g1_t *x, *x_ext_fft;
 
     CHECK(n2 <= ks->fs->max_width);
     CHECK(is_power_of_two(n2));
@@ -426,20 +476,23 @@ C_KZG_RET new_fk20_multi_settings(FK20MultiSettings *fk, uint64_t n2, uint64_t c
     fk->chunk_len = chunk_len;
 
     // `x_ext_fft_files` is two dimensional. Allocate space for pointers to the rows.
-    TRY(new_g1_array_2(&fk->x_ext_fft_files, chunk_len * sizeof *fk->x_ext_fft_files));
+    TRY(new_g1_affine_array_2(&fk->x_ext_fft_files, chunk_len * sizeof *fk->x_ext_fft_files));
 
     TRY(new_g1_array(&x, k));
+    TRY(new_g1_array(&x_ext_fft, 2 * k));
     for (uint64_t offset = 0; offset < chunk_len; offset++) {
         uint64_t start = n - chunk_len - 1 - offset;
         for (uint64_t i = 0, j = start; i + 1 < k; i++, j -= chunk_len) {
-            x[i] = ks->secret_g1[j];
+            g1_from_affine(&x[i], &ks->secret_g1[j]);
         }
         x[k - 1] = g1_identity;
 
-        TRY(new_g1_array(&fk->x_ext_fft_files[offset], 2 * k));
-        TRY(toeplitz_part_1(fk->x_ext_fft_files[offset], x, k, ks->fs));
+        TRY(toeplitz_part_1(x_ext_fft, x, k, ks->fs));
+        TRY(new_g1_affine_array(&fk->x_ext_fft_files[offset], 2 * k));
+        g1_to_affine(fk->x_ext_fft_files[offset], x_ext_fft, 2 * k);
     }
 
+    free(x_ext_fft);
     free(x);
     return C_KZG_OK;
 }
@@ -25,7 +25,7 @@
  */
 typedef struct {
     const KZGSettings *ks;  /**< The corresponding settings for performing KZG proofs */
-    g1_t *x_ext_fft;        /**< The output of the first part of the Toeplitz process */
+    g1_affine_t *x_ext_fft; /**< The first part of the Toeplitz process, in affine coordinates and bit-reversed order */
     uint64_t x_ext_fft_len; /**< The length of the `x_ext_fft_len` array (TODO - do we need this?)*/
 } FK20SingleSettings;
 
@@ -33,14 +33,15 @@ typedef struct {
  * Stores the setup and parameters needed for computing FK20 multi proofs.
  */
 typedef struct {
-    const KZGSettings *ks;  /**< The corresponding settings for performing KZG proofs */
-    uint64_t chunk_len;     /**< TODO */
-    g1_t **x_ext_fft_files; /**< TODO */
-    uint64_t length;        /**< TODO */
+    const KZGSettings *ks;         /**< The corresponding settings for performing KZG proofs */
+    uint64_t chunk_len;            /**< TODO */
+    g1_affine_t **x_ext_fft_files; /**< TODO */
+    uint64_t length;               /**< TODO */
 } FK20MultiSettings;
 
 C_KZG_RET toeplitz_part_1(g1_t *out, const g1_t *x, uint64_t n, const FFTSettings *fs);
-C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_t *x_ext_fft, const FFTSettings *fs);
+C_KZG_RET toeplitz_part_2(g1_t *out, const poly *toeplitz_coeffs, const g1_affine_t *x_ext_fft,
+                          const FFTSettings *fs);
 C_KZG_RET toeplitz_part_3(g1_t *out, const g1_t *h_ext_fft, uint64_t n2, const FFTSettings *fs);
 C_KZG_RET toeplitz_coeffs_stride(poly *out, const poly *in, uint64_t offset, uint64_t stride);
 C_KZG_RET toeplitz_coeffs_step(poly *out, const poly *in);
@@ -61,7 +61,7 @@ void fk_single(void) {
 
     // Verify the proof at each root of unity
     for (uint64_t i = 0; i < 2 * poly_len; i++) {
-        x = fs.expanded_roots_of_unity[i];
+        fft_root_of_unity(&x, &fs, false, i);
         eval_poly(&y, &p, &x);
         proof = all_proofs[reverse_bits_limited(2 * poly_len, i)];
 
@@ -76,7 +76,7 @@ void fk_single(void) {
 
     // Verify the proof at each root of unity
     for (uint64_t i = 0; i < 2 * poly_len; i++) {
-        x = fs.expanded_roots_of_unity[i];
+        fft_root_of_unity(&x, &fs, false, i);
         eval_poly(&y, &p, &x);
         proof = all_proofs[i];
 
@@ -132,7 +132,7 @@ void fk_single_strided(void) {
 
     // Verify the proof at each root of unity
     for (uint64_t i = 0; i < 2 * poly_len; i++) {
-        x = fs.expanded_roots_of_unity[i * stride];
+        fft_root_of_unity(&x, &fs, false, i * stride);
         eval_poly(&y, &p, &x);
         proof = all_proofs[reverse_bits_limited(2 * poly_len, i)];
 
@@ -239,7 +239,7 @@ void fk_multi_0(void) {
         bool result;
 
         domain_pos = reverse_bits_limited(2 * chunk_count, pos);
-        x = fs.expanded_roots_of_unity[domain_pos * domain_stride];
+        fft_root_of_unity(&x, &fs, false, domain_pos * domain_stride);
 
         // The ys from the extended coeffients
         for (uint64_t i = 0; i < chunk_len; i++) {
@@ -251,7 +251,8 @@ void fk_multi_0(void) {
         stride = fs.max_width / chunk_len;
         for (uint64_t i = 0; i < chunk_len; i++) {
             fr_t z;
-            fr_mul(&z, &x, &fs.expanded_roots_of_unity[i * stride]);
+            fft_root_of_unity(&z, &fs, false, i * stride);
+            fr_mul(&z, &z, &x);
             eval_poly(&ys2[i], &p, &z);
         }
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2021 Benjamin Edgington
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h> // malloc(), free(), atoi()
+#include <stdio.h>  // printf()
+#include <assert.h> // assert()
+#include <unistd.h> // EXIT_SUCCESS/FAILURE
+#include "bench_util.h"
+#include "test_util.h"
+
+typedef void (*lincomb_fn)(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len);
+
+#define NUM_THREADS 4
+
+void lincomb_parallel(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
+    g1_linear_combination_parallel(out, p, coeffs, len, NUM_THREADS);
+}
+
+// Run the benchmark for `max_seconds` and return the time per iteration in nanoseconds.
+long run_bench(lincomb_fn fn, int scale, int max_seconds) {
+    timespec_t t0, t1;
+    unsigned long total_time = 0, nits = 0;
+    uint64_t len = (uint64_t)1 << scale;
+    g1_t out;
+
+    // Allocate on the heap to avoid stack overflow for large sizes
+    g1_t *points = malloc(len * sizeof(g1_t));
+    fr_t *coeffs = malloc(len * sizeof(fr_t));
+
+    // Fill with randomness
+    for (uint64_t i = 0; i < len; i++) {
+        points[i] = rand_g1();
+        coeffs[i] = rand_fr();
+    }
+
+    while (total_time < max_seconds * NANO) {
+        clock_gettime(CLOCK_REALTIME, &t0);
+        fn(&out, points, coeffs, len);
+        clock_gettime(CLOCK_REALTIME, &t1);
+        nits++;
+        total_time += tdiff(t0, t1);
+    }
+
+    free(coeffs);
+    free(points);
+
+    return total_time / nits;
+}
+
+// As run_bench(), but using a fixed-base table of up to `rows` times the number of points.
+long run_bench_fixed_base(int scale, int rows, int max_seconds) {
+    timespec_t t0, t1;
+    unsigned long total_time = 0, nits = 0;
+    uint64_t len = (uint64_t)1 << scale;
+    int bits = g1_fixed_base_window_bits(len, rows * len);
+    g1_t out;
+
+    g1_t *points = malloc(len * sizeof(g1_t));
+    fr_t *coeffs = malloc(len * sizeof(fr_t));
+    g1_affine_t *points_affine = malloc(len * sizeof(g1_affine_t));
+    g1_affine_t *table = malloc(g1_fixed_base_table_size(len, bits) * sizeof(g1_affine_t));
+
+    for (uint64_t i = 0; i < len; i++) {
+        points[i] = rand_g1();
+        coeffs[i] = rand_fr();
+    }
+    g1_to_affine(points_affine, points, len);
+    bool ok = g1_fixed_base_precompute(table, points_affine, len, bits);
+    assert(ok);
+
+    while (total_time < max_seconds * NANO) {
+        clock_gettime(CLOCK_REALTIME, &t0);
+        g1_fixed_base_linear_combination(&out, table, len, bits, coeffs, len, 1);
+        clock_gettime(CLOCK_REALTIME, &t1);
+        nits++;
+        total_time += tdiff(t0, t1);
+    }
+
+    free(table);
+    free(points_affine);
+    free(coeffs);
+    free(points);
+
+    return total_time / nits;
+}
+
+int main(int argc, char *argv[]) {
+    int nsec = 0;
+
+    switch (argc) {
+    case 1:
+        nsec = NSEC;
+        break;
+    case 2:
+        nsec = atoi(argv[1]);
+        break;
+    default:
+        break;
+    };
+
+    if (nsec == 0) {
+        printf("Usage: %s [test time in seconds > 0]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("*** Benchmarking G1 linear combination, %d second%s per test.\n", nsec, nsec == 1 ? "" : "s");
+    for (int scale = 1; scale <= 16; scale++) {
+        printf("g1_linear_combination_slow/scale_%d %lu ns/op\n", scale,
+               run_bench(g1_linear_combination_slow, scale, nsec));
+        printf("g1_linear_combination/scale_%d %lu ns/op\n", scale, run_bench(g1_linear_combination, scale, nsec));
+        printf("g1_linear_combination_parallel_%d/scale_%d %lu ns/op\n", NUM_THREADS, scale,
+               run_bench(lincomb_parallel, scale, nsec));
+        printf("g1_fixed_base_linear_combination_32x/scale_%d %lu ns/op\n", scale,
+               run_bench_fixed_base(scale, 32, nsec));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -31,12 +31,20 @@
 /**
  * Make a KZG commitment to a polynomial.
  *
+ * If the settings have been through #precompute_kzg_settings then the fixed-base table is used. The work is shared
+ * between `ks->num_threads` threads.
+ *
  * @param[out] out The commitment to the polynomial, in the form of a G1 group point
  * @param[in]  p   The polynomial to be committed to
  * @param[in]  ks  The settings containing the secrets, previously initialised with #new_kzg_settings
  */
 void commit_to_poly(g1_t *out, const poly *p, const KZGSettings *ks) {
-    g1_linear_combination(out, ks->secret_g1, p->coeffs, p->length);
+    if (ks->secret_g1_table != NULL) {
+        g1_fixed_base_linear_combination(out, ks->secret_g1_table, ks->length, ks->secret_g1_table_bits, p->coeffs,
+                                         p->length, ks->num_threads);
+    } else {
+        g1_linear_combination_affine(out, ks->secret_g1, p->coeffs, p->length, ks->num_threads);
+    }
 }
 
 /**
@@ -59,6 +67,9 @@ C_KZG_RET compute_proof_single(g1_t *out, const poly *p, const fr_t *x0, const K
  *
  * Given a @p commitment to a polynomial, a @p proof for @p x, and the claimed value @p y at @p x, verify the claim.
  *
+ * The check `e(C - [y]G1, G2) == e(proof, [s - x]G2)` is rearranged to `e(C - [y]G1 + [x]proof, G2) == e(proof, [s]G2)`
+ * so that both G2 points are fixed and we can use their prepared forms from @p ks.
+ *
  * @param[out] out        `true` if the proof is valid, `false` if not
  * @param[in]  commitment The commitment to a polynomial
  * @param[in]  proof      A proof of the value of the polynomial at the point @p x
@@ -66,18 +77,132 @@ C_KZG_RET compute_proof_single(g1_t *out, const poly *p, const fr_t *x0, const K
  * @param[in]  y          The claimed value of the polynomial at @p x
  * @param[in]  ks  The settings containing the secrets, previously initialised with #new_kzg_settings
  * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
  */
 C_KZG_RET check_proof_single(bool *out, const g1_t *commitment, const g1_t *proof, const fr_t *x, fr_t *y,
                              const KZGSettings *ks) {
-    g2_t x_g2, s_minus_x;
-    g1_t y_g1, commitment_minus_y;
-    g2_mul(&x_g2, &g2_generator, x);
-    g2_sub(&s_minus_x, &ks->secret_g2[1], &x_g2);
+    g1_t x_proof, y_g1, lhs;
+
+    CHECK(ks->length > 1);
+
+    g1_mul(&x_proof, proof, x);
     g1_mul(&y_g1, &g1_generator, y);
-    g1_sub(&commitment_minus_y, commitment, &y_g1);
+    g1_add_or_dbl(&lhs, commitment, &x_proof);
+    g1_sub(&lhs, &lhs, &y_g1);
 
-    *out = pairings_verify(&commitment_minus_y, &g2_generator, proof, &s_minus_x);
+    *out = pairings_verify_prepared(&lhs, ks->g2_generator_prepared, proof, &ks->secret_g2_prepared[0]);
+
+    return C_KZG_OK;
+}
+
+/** Domain separator for the challenge in #check_proof_single_batch. */
+static const char batch_domain[16] = "C_KZG_BATCH_V1__";
+
+/**
+ * Derive the random challenge for batch verification from everything that is being verified.
+ *
+ * @param[out] out         The challenge
+ * @param[in]  commitments Array of commitments, length @p n
+ * @param[in]  proofs      Array of proofs, length @p n
+ * @param[in]  xs          Array of evaluation points, length @p n
+ * @param[in]  ys          Array of claimed values, length @p n
+ * @param[in]  n           The number of proofs
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET compute_batch_challenge(fr_t *out, const g1_t *commitments, const g1_t *proofs, const fr_t *xs,
+                                         const fr_t *ys, uint64_t n) {
+    const uint64_t item_len = 48 + 48 + 32 + 32;
+    uint64_t msg_len = sizeof batch_domain + 8 + n * item_len;
+    byte *msg, *p;
+
+    TRY(c_kzg_malloc((void **)&msg, msg_len));
+    p = msg;
+    for (int i = 0; i < sizeof batch_domain; i++) {
+        *p++ = batch_domain[i];
+    }
+    for (int i = 0; i < 8; i++) {
+        *p++ = (byte)(n >> (8 * i));
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        g1_to_bytes(p, &commitments[i]);
+        g1_to_bytes(p + 48, &proofs[i]);
+        fr_to_bytes(p + 96, &xs[i]);
+        fr_to_bytes(p + 128, &ys[i]);
+        p += item_len;
+    }
+    fr_from_hash(out, msg, msg_len);
 
+    free(msg);
+    return C_KZG_OK;
+}
+
+/**
+ * Check many KZG proofs at single points at once.
+ *
+ * Each proof `i` claims that the polynomial committed to by `commitments[i]` has value `ys[i]` at `xs[i]`. The
+ * individual checks are `e(C_i - [y_i]G1, G2) == e(proof_i, [s - x_i]G2)`, which we rearrange to
+ * `e(C_i - [y_i]G1 + [x_i]proof_i, G2) == e(proof_i, [s]G2)`, so that the G2 side no longer depends on `i`. Taking a
+ * random linear combination with powers of a challenge `r` then gives a single check:
+ *
+ * ```
+ * e(sum_i [r^i](C_i - [y_i]G1 + [x_i]proof_i), G2) == e(sum_i [r^i]proof_i, [s]G2)
+ * ```
+ *
+ * That costs two multi-scalar multiplications and two pairings however many proofs there are. The challenge is
+ * derived by hashing all the inputs, so that a forger cannot choose proofs that cancel each other out.
+ *
+ * @remark If the result is `false` then at least one of the proofs is invalid, but we don't know which.
+ *
+ * @param[out] out         `true` if all the proofs are valid, `false` if not
+ * @param[in]  commitments Array of commitments to polynomials, length @p n
+ * @param[in]  proofs      Array of proofs, length @p n
+ * @param[in]  xs          Array of points at which the proofs are to be checked, length @p n
+ * @param[in]  ys          Array of the claimed values of the polynomials, length @p n
+ * @param[in]  n           The number of proofs
+ * @param[in]  ks          The settings containing the secrets, previously initialised with #new_kzg_settings
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS Invalid parameters were supplied
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET check_proof_single_batch(bool *out, const g1_t *commitments, const g1_t *proofs, const fr_t *xs,
+                                   const fr_t *ys, uint64_t n, const KZGSettings *ks) {
+    fr_t r, *coeffs, y_sum = fr_zero, tmp;
+    g1_t *points, lhs, rhs;
+
+    CHECK(ks->length > 1);
+    if (n == 0) {
+        *out = true;
+        return C_KZG_OK;
+    }
+
+    TRY(compute_batch_challenge(&r, commitments, proofs, xs, ys, n));
+
+    // The left hand side is one linear combination over the commitments, proofs and the generator
+    TRY(new_g1_array(&points, 2 * n + 1));
+    if (new_fr_array(&coeffs, 2 * n + 1) != C_KZG_OK) {
+        free(points);
+        return C_KZG_MALLOC;
+    }
+    coeffs[0] = fr_one;
+    for (uint64_t i = 0; i < n; i++) {
+        if (i > 0) fr_mul(&coeffs[i], &coeffs[i - 1], &r);
+        fr_mul(&coeffs[n + i], &coeffs[i], &xs[i]);
+        fr_mul(&tmp, &coeffs[i], &ys[i]);
+        fr_add(&y_sum, &y_sum, &tmp);
+        points[i] = commitments[i];
+        points[n + i] = proofs[i];
+    }
+    points[2 * n] = g1_generator;
+    fr_negate(&coeffs[2 * n], &y_sum);
+
+    g1_linear_combination_parallel(&lhs, points, coeffs, 2 * n + 1, ks->num_threads);
+    g1_linear_combination_parallel(&rhs, proofs, coeffs, n, ks->num_threads);
+
+    *out = pairings_verify_prepared(&lhs, ks->g2_generator_prepared, &rhs, &ks->secret_g2_prepared[0]);
+
+    free(points);
+    free(coeffs);
     return C_KZG_OK;
 }
 
@@ -135,12 +260,17 @@ C_KZG_RET compute_proof_multi(g1_t *out, const poly *p, const fr_t *x0, uint64_t
  * Given a @p commitment to a polynomial, a @p proof for @p x, and the claimed values @p y at values @p x `* w^i`,
  * verify the claim. Here, `w` is an `n`th root of unity.
  *
+ * With `I` the polynomial interpolating the claimed values, the check `e(C - [I(s)]G1, G2) == e(proof, [s^n - x^n]G2)`
+ * is rearranged to `e(C - [I(s)]G1 + [x^n]proof, G2) == e(proof, [s^n]G2)` so that both G2 points are fixed and we can
+ * use their prepared forms from @p ks.
+ *
  * @param[out] out        `true` if the proof is valid, `false` if not
  * @param[in]  commitment The commitment to a polynomial
  * @param[in]  proof      A proof of the value of the polynomial at the points @p x * w^i
  * @param[in]  x          The generator x-value for the evaluation points
  * @param[in]  ys         The claimed value of the polynomial at the points @p x * w^i
- * @param[in]  n          The number of points at which to evaluate the polynomial, must be a power of two
+ * @param[in]  n          The number of points at which to evaluate the polynomial, a power of two less than
+ *                        `ks->length`
  * @param[in]  ks         The settings containing the secrets, previously initialised with #new_kzg_settings
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_BADARGS Invalid parameters were supplied
@@ -150,38 +280,29 @@ C_KZG_RET compute_proof_multi(g1_t *out, const poly *p, const fr_t *x0, uint64_t
 C_KZG_RET check_proof_multi(bool *out, const g1_t *commitment, const g1_t *proof, const fr_t *x, const fr_t *ys,
                             uint64_t n, const KZGSettings *ks) {
     poly interp;
-    fr_t inv_x, inv_x_pow, x_pow;
-    g2_t xn2, xn_minus_yn;
-    g1_t is1, commit_minus_interp;
+    fr_t x_pow;
+    g1_t is1, xn_proof, lhs;
 
     CHECK(is_power_of_two(n));
+    CHECK(n > 0 && n < ks->length);
 
     // Interpolate at a coset.
     TRY(new_poly(&interp, n));
-    TRY(fft_fr(interp.coeffs, ys, true, n, ks->fs));
-
-    // Because it is a coset, not the subgroup, we have to multiply the polynomial coefficients by x^-i
-    fr_inv(&inv_x, x);
-    inv_x_pow = inv_x;
-    for (uint64_t i = 1; i < n; i++) {
-        fr_mul(&interp.coeffs[i], &interp.coeffs[i], &inv_x_pow);
-        fr_mul(&inv_x_pow, &inv_x_pow, &inv_x);
-    }
-
-    // [x^n]_2
-    fr_inv(&x_pow, &inv_x_pow);
-    g2_mul(&xn2, &g2_generator, &x_pow);
+    TRY(fft_fr_coset(interp.coeffs, ys, true, n, x, ks->fs));
 
-    // [s^n - x^n]_2
-    g2_sub(&xn_minus_yn, &ks->secret_g2[n], &xn2);
+    // [x^n]proof
+    fr_pow(&x_pow, x, n);
+    g1_mul(&xn_proof, proof, &x_pow);
 
     // [interpolation_polynomial(s)]_1
     commit_to_poly(&is1, &interp, ks);
 
-    // [commitment - interpolation_polynomial(s)]_1 = [commit]_1 - [interpolation_polynomial(s)]_1
-    g1_sub(&commit_minus_interp, commitment, &is1);
+    // [commitment - interpolation_polynomial(s)]_1 + [x^n]proof
+    g1_sub(&lhs, commitment, &is1);
+    g1_add_or_dbl(&lhs, &lhs, &xn_proof);
 
-    *out = pairings_verify(&commit_minus_interp, &g2_generator, proof, &xn_minus_yn);
+    *out = pairings_verify_prepared(&lhs, ks->g2_generator_prepared, proof,
+                                    &ks->secret_g2_prepared[log2_pow2(n)]);
 
     free_poly(&interp);
     return C_KZG_OK;
@@ -190,7 +311,9 @@ C_KZG_RET check_proof_multi(bool *out, const g1_t *commitment, const g1_t *proof
 /**
  * Initialise a KZGSettings structure.
  *
- * Space is allocated for the provided secrets (the "trusted setup"), and copies of the secrets are made.
+ * Space is allocated for the provided secrets (the "trusted setup"), and copies of the secrets are made. The G1 secrets
+ * are stored in affine coordinates, which take less space and are quicker to add. The G2 points that proofs are checked
+ * against are prepared for pairings.
  *
  * @remark As with all functions prefixed `new_`, this allocates memory that needs to be reclaimed by calling the
  * corresponding `free_` function. In this case, #free_kzg_settings.
@@ -206,20 +329,63 @@ C_KZG_RET check_proof_multi(bool *out, const g1_t *commitment, const g1_t *proof
  */
 C_KZG_RET new_kzg_settings(KZGSettings *ks, const g1_t *secret_g1, const g2_t *secret_g2, uint64_t length,
                            FFTSettings const *fs) {
+    int num_prepared = 0;
 
     CHECK(length >= fs->max_width);
     ks->length = length;
 
     // Allocate space for the secrets
-    TRY(new_g1_array(&ks->secret_g1, ks->length));
+    TRY(new_g1_affine_array(&ks->secret_g1, ks->length));
     TRY(new_g2_array(&ks->secret_g2, ks->length));
 
     // Populate the secrets
+    g1_to_affine(ks->secret_g1, secret_g1, ks->length);
     for (uint64_t i = 0; i < ks->length; i++) {
-        ks->secret_g1[i] = secret_g1[i];
         ks->secret_g2[i] = secret_g2[i];
     }
+
+    // Prepare the generator and the powers of two of the G2 secrets
+    while (((uint64_t)1 << num_prepared) < ks->length) num_prepared++;
+    TRY(new_g2_prepared_array(&ks->g2_generator_prepared, 1));
+    TRY(new_g2_prepared_array(&ks->secret_g2_prepared, num_prepared));
+    g2_prepare(ks->g2_generator_prepared, &g2_generator);
+    for (int i = 0; i < num_prepared; i++) {
+        g2_prepare(&ks->secret_g2_prepared[i], &ks->secret_g2[(uint64_t)1 << i]);
+    }
     ks->fs = fs;
+    ks->secret_g1_table = NULL;
+    ks->secret_g1_table_bits = 0;
+    ks->num_threads = 1;
+
+    return C_KZG_OK;
+}
+
+/**
+ * Precompute a fixed-base table for the G1 secrets to speed up commitments.
+ *
+ * The G1 secrets never change, so we can trade memory for time by storing multiples of them. The table is the largest
+ * that is worthwhile within the @p max_bytes budget. Subsequent calls to #commit_to_poly use it automatically.
+ *
+ * @param[in,out] ks        Settings previously initialised with #new_kzg_settings
+ * @param[in]     max_bytes The maximum amount of memory to use for the table
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The budget is too small for any table
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET precompute_kzg_settings(KZGSettings *ks, uint64_t max_bytes) {
+    int bits = g1_fixed_base_window_bits(ks->length, max_bytes / sizeof(g1_affine_t));
+    g1_affine_t *table;
+
+    CHECK(bits > 0);
+    TRY(new_g1_affine_array(&table, g1_fixed_base_table_size(ks->length, bits)));
+    if (!g1_fixed_base_precompute(table, ks->secret_g1, ks->length, bits)) {
+        free(table);
+        return C_KZG_MALLOC;
+    }
+
+    free(ks->secret_g1_table);
+    ks->secret_g1_table = table;
+    ks->secret_g1_table_bits = bits;
 
     return C_KZG_OK;
 }
@@ -232,5 +398,9 @@ C_KZG_RET new_kzg_settings(KZGSettings *ks, const g1_t *secret_g1, const g2_t *s
 void free_kzg_settings(KZGSettings *ks) {
     free(ks->secret_g1);
     free(ks->secret_g2);
+    free(ks->g2_generator_prepared);
+    free(ks->secret_g2_prepared);
+    free(ks->secret_g1_table);
+    ks->secret_g1_table = NULL;
     ks->length = 0;
 }
@@ -25,19 +25,27 @@
  * Initialise with #new_kzg_settings. Free after use with #free_kzg_settings.
  */
 typedef struct {
-    const FFTSettings *fs; /**< The corresponding settings for performing FFTs */
-    g1_t *secret_g1;       /**< G1 group elements from the trusted setup */
-    g2_t *secret_g2;       /**< G2 group elements from the trusted setup */
-    uint64_t length;       /**< The number of elements in secret_g1 and secret_g2 */
+    const FFTSettings *fs;                /**< The corresponding settings for performing FFTs */
+    g1_affine_t *secret_g1;               /**< G1 group elements from the trusted setup, in affine coordinates */
+    g2_t *secret_g2;                      /**< G2 group elements from the trusted setup */
+    uint64_t length;                      /**< The number of elements in secret_g1 and secret_g2 */
+    g2_prepared_t *g2_generator_prepared; /**< The G2 generator, prepared for pairings */
+    g2_prepared_t *secret_g2_prepared;    /**< `secret_g2[2^i]` prepared for pairings, for each `2^i < length` */
+    g1_affine_t *secret_g1_table;         /**< Optional fixed-base table for secret_g1, see #precompute_kzg_settings */
+    int secret_g1_table_bits;             /**< The window size of secret_g1_table in bits */
+    int num_threads;                      /**< The number of threads to use for commitments, one by default */
 } KZGSettings;
 
 void commit_to_poly(g1_t *out, const poly *p, const KZGSettings *ks);
 C_KZG_RET compute_proof_single(g1_t *out, const poly *p, const fr_t *x0, const KZGSettings *ks);
 C_KZG_RET check_proof_single(bool *out, const g1_t *commitment, const g1_t *proof, const fr_t *x, fr_t *y,
                              const KZGSettings *ks);
+C_KZG_RET check_proof_single_batch(bool *out, const g1_t *commitments, const g1_t *proofs, const fr_t *xs,
+                                   const fr_t *ys, uint64_t n, const KZGSettings *ks);
 C_KZG_RET compute_proof_multi(g1_t *out, const poly *p, const fr_t *x0, uint64_t n, const KZGSettings *ks);
 C_KZG_RET check_proof_multi(bool *out, const g1_t *commitment, const g1_t *proof, const fr_t *x, const fr_t *ys,
                             uint64_t n, const KZGSettings *ks);
 C_KZG_RET new_kzg_settings(KZGSettings *ks, const g1_t *secret_g1, const g2_t *secret_g2, uint64_t length,
                            const FFTSettings *fs);
+C_KZG_RET precompute_kzg_settings(KZGSettings *ks, uint64_t max_bytes);
 void free_kzg_settings(KZGSettings *ks);
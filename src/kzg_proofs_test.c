@@ -108,7 +108,8 @@ void proof_multi(void) {
 
     // y_i is the value of the polynomial at each x_i
     for (int i = 0; i < coset_len; i++) {
-        fr_mul(&tmp, &x, &ks2.fs->expanded_roots_of_unity[i]);
+        fft_root_of_unity(&tmp, ks2.fs, false, i);
+        fr_mul(&tmp, &tmp, &x);
         eval_poly(&y[i], &p, &tmp);
     }
 
@@ -128,6 +129,61 @@ void proof_multi(void) {
     free_poly(&p);
 }
 
+void proof_single_batch(void) {
+    uint64_t secrets_len = 65, num_proofs = 20;
+    FFTSettings fs;
+    KZGSettings ks;
+    g1_t s1[secrets_len];
+    g2_t s2[secrets_len];
+    poly p[num_proofs];
+    g1_t commitments[num_proofs], proofs[num_proofs];
+    fr_t xs[num_proofs], ys[num_proofs];
+    bool result;
+
+    generate_trusted_setup(s1, s2, &secret, secrets_len);
+    TEST_CHECK(C_KZG_OK == new_fft_settings(&fs, 6));
+    TEST_CHECK(C_KZG_OK == new_kzg_settings(&ks, s1, s2, secrets_len, &fs));
+
+    // Proofs for a selection of different polynomials and points
+    for (int i = 0; i < num_proofs; i++) {
+        TEST_CHECK(C_KZG_OK == new_poly(&p[i], 2 + 3 * i));
+        for (int j = 0; j < p[i].length; j++) {
+            p[i].coeffs[j] = rand_fr();
+        }
+        xs[i] = rand_fr();
+        commit_to_poly(&commitments[i], &p[i], &ks);
+        TEST_CHECK(C_KZG_OK == compute_proof_single(&proofs[i], &p[i], &xs[i], &ks));
+        eval_poly(&ys[i], &p[i], &xs[i]);
+    }
+
+    for (int n = 0; n <= num_proofs; n++) {
+        TEST_CHECK(C_KZG_OK == check_proof_single_batch(&result, commitments, proofs, xs, ys, n, &ks));
+        TEST_CHECK(true == result);
+        TEST_MSG("Failed with %d proofs", n);
+    }
+
+    // Any one bad value spoils the batch
+    fr_add(&ys[7], &ys[7], &fr_one);
+    TEST_CHECK(C_KZG_OK == check_proof_single_batch(&result, commitments, proofs, xs, ys, num_proofs, &ks));
+    TEST_CHECK(false == result);
+    fr_sub(&ys[7], &ys[7], &fr_one);
+
+    // As does swapping two proofs
+    TEST_CHECK(C_KZG_OK == check_proof_single_batch(&result, commitments, proofs, xs, ys, num_proofs, &ks));
+    TEST_CHECK(true == result);
+    g1_t tmp = proofs[3];
+    proofs[3] = proofs[4];
+    proofs[4] = tmp;
+    TEST_CHECK(C_KZG_OK == check_proof_single_batch(&result, commitments, proofs, xs, ys, num_proofs, &ks));
+    TEST_CHECK(false == result);
+
+    for (int i = 0; i < num_proofs; i++) {
+        free_poly(&p[i]);
+    }
+    free_fft_settings(&fs);
+    free_kzg_settings(&ks);
+}
+
 void commit_to_nil_poly(void) {
     poly a;
     FFTSettings fs;
@@ -150,10 +206,58 @@ void commit_to_nil_poly(void) {
     free_kzg_settings(&ks);
 }
 
+void commit_with_precompute(void) {
+    poly p;
+    FFTSettings fs;
+    KZGSettings ks;
+    uint64_t secrets_len = 256;
+    g1_t s1[secrets_len];
+    g2_t s2[secrets_len];
+    g1_t expected, result;
+
+    generate_trusted_setup(s1, s2, &secret, secrets_len);
+    TEST_CHECK(C_KZG_OK == new_fft_settings(&fs, 8));
+    TEST_CHECK(C_KZG_OK == new_kzg_settings(&ks, s1, s2, secrets_len, &fs));
+
+    // A budget too small to hold even the points themselves is rejected
+    TEST_CHECK(C_KZG_BADARGS == precompute_kzg_settings(&ks, secrets_len * sizeof(g1_t)));
+    TEST_CHECK(NULL == ks.secret_g1_table);
+
+    new_poly(&p, secrets_len);
+    for (int i = 0; i < secrets_len; i++) {
+        p.coeffs[i] = rand_fr();
+    }
+    commit_to_poly(&expected, &p, &ks);
+
+    TEST_CHECK(C_KZG_OK == precompute_kzg_settings(&ks, 64 * secrets_len * sizeof(g1_t)));
+    TEST_CHECK(NULL != ks.secret_g1_table);
+    commit_to_poly(&result, &p, &ks);
+    TEST_CHECK(g1_equal(&expected, &result));
+
+    // As does using more threads, with and without the table
+    ks.num_threads = 4;
+    commit_to_poly(&result, &p, &ks);
+    TEST_CHECK(g1_equal(&expected, &result));
+    g1_linear_combination_affine(&result, ks.secret_g1, p.coeffs, p.length, ks.num_threads);
+    TEST_CHECK(g1_equal(&expected, &result));
+
+    // Shorter polynomials work too
+    p.length = 10;
+    g1_linear_combination(&expected, s1, p.coeffs, p.length);
+    commit_to_poly(&result, &p, &ks);
+    TEST_CHECK(g1_equal(&expected, &result));
+
+    free_poly(&p);
+    free_fft_settings(&fs);
+    free_kzg_settings(&ks);
+}
+
 TEST_LIST = {
     {"KZG_PROOFS_TEST", title},
     {"proof_single", proof_single},
+    {"proof_single_batch", proof_single_batch},
     {"proof_multi", proof_multi},
     {"commit_to_nil_poly", commit_to_nil_poly},
+    {"commit_with_precompute", commit_with_precompute},
     {NULL, NULL} /* zero record marks the end of the list */
 };
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2021 Benjamin Edgington
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file parallel.c
+ *
+ * A minimal fork-join helper for spreading work over threads.
+ *
+ * Tasks are divided into contiguous blocks, one per thread, so the assignment of work to threads depends only on the
+ * number of tasks and threads. Callers that combine per-task results in task order therefore get deterministic output
+ * regardless of scheduling.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include "parallel.h"
+
+/** The largest number of threads we will start for a single #parallel_for. */
+#define PARALLEL_MAX_THREADS 256
+
+/** Arguments for a single worker thread. */
+typedef struct {
+    parallel_fn fn;
+    void *ctx;
+    int thread;
+    uint64_t start, end;
+} parallel_job;
+
+static void *parallel_worker(void *arg) {
+    parallel_job *job = arg;
+    job->fn(job->ctx, job->thread, job->start, job->end);
+    return NULL;
+}
+
+/**
+ * The number of threads that #parallel_for will actually use.
+ *
+ * This is useful for allocating per-thread working space.
+ *
+ * @param[in] num_threads The requested number of threads, with any value below one meaning one
+ * @param[in] num_tasks   The number of tasks to be shared between them
+ * @return The number of threads, at least one
+ */
+int parallel_num_threads(int num_threads, uint64_t num_tasks) {
+    if (num_threads < 1) return 1;
+    if (num_threads > PARALLEL_MAX_THREADS) num_threads = PARALLEL_MAX_THREADS;
+    if (num_tasks < (uint64_t)num_threads) num_threads = num_tasks;
+    return num_threads > 1 ? num_threads : 1;
+}
+
+/**
+ * Run tasks in parallel and wait for them all to finish.
+ *
+ * Tasks `[0, num_tasks)` are split into contiguous blocks of near-equal size, one for each thread. The calling thread
+ * does the first block itself. If a thread cannot be started then its block is also run on the calling thread, so the
+ * work always gets done.
+ *
+ * @param[in] fn          The function that does the work
+ * @param[in] ctx         Context passed to every call of @p fn
+ * @param[in] num_tasks   The number of tasks
+ * @param[in] num_threads The number of threads to use, see #parallel_num_threads
+ */
+void parallel_for(parallel_fn fn, void *ctx, uint64_t num_tasks, int num_threads) {
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    parallel_job jobs[PARALLEL_MAX_THREADS];
+    bool started[PARALLEL_MAX_THREADS];
+
+    num_threads = parallel_num_threads(num_threads, num_tasks);
+    for (int t = 0; t < num_threads; t++) {
+        jobs[t] = (parallel_job){fn, ctx, t, num_tasks * t / num_threads, num_tasks * (t + 1) / num_threads};
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, parallel_worker, &jobs[t]) == 0;
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        if (!started[t]) parallel_worker(&jobs[t]);
+    }
+    for (int t = 1; t < num_threads; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2021 Benjamin Edgington
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file parallel.h
+ *
+ * A minimal fork-join helper for spreading work over threads.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+
+/**
+ * A unit of parallel work.
+ *
+ * Processes the tasks numbered @p start up to, but not including, @p end. Each call gets a distinct @p thread in the
+ * range `[0, num_threads)`, which can be used to index per-thread working space.
+ */
+typedef void (*parallel_fn)(void *ctx, int thread, uint64_t start, uint64_t end);
+
+int parallel_num_threads(int num_threads, uint64_t num_tasks);
+void parallel_for(parallel_fn fn, void *ctx, uint64_t num_tasks, int num_threads);
+
+#endif // PARALLEL_H
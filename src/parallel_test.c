@@ -0,0 +1,96 @@
+/*
+ * Copyright 2021 Benjamin Edgington
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../inc/acutest.h"
+#include "test_util.h"
+#include "parallel.h"
+
+#define NUM_TASKS 1000
+
+typedef struct {
+    int count[NUM_TASKS];
+    int thread[NUM_TASKS];
+    int num_threads;
+} test_ctx;
+
+static void record_task(void *ctx, int thread, uint64_t start, uint64_t end) {
+    test_ctx *c = ctx;
+    for (uint64_t i = start; i < end; i++) {
+        c->count[i]++;
+        c->thread[i] = thread;
+    }
+}
+
+void parallel_num_threads_works(void) {
+    TEST_CHECK(1 == parallel_num_threads(0, 10));
+    TEST_CHECK(1 == parallel_num_threads(-1, 1000));
+    TEST_CHECK(1 == parallel_num_threads(-1, 0));
+    TEST_CHECK(1 == parallel_num_threads(4, 0));
+    TEST_CHECK(1 == parallel_num_threads(4, 1));
+    TEST_CHECK(3 == parallel_num_threads(4, 3));
+    TEST_CHECK(4 == parallel_num_threads(4, 100));
+}
+
+void parallel_for_runs_every_task_once(void) {
+    for (int num_threads = 1; num_threads <= 16; num_threads++) {
+        test_ctx ctx = {{0}};
+        parallel_for(record_task, &ctx, NUM_TASKS, num_threads);
+        for (int i = 0; i < NUM_TASKS; i++) {
+            TEST_CHECK(1 == ctx.count[i]);
+            TEST_MSG("Task %d ran %d times with %d threads", i, ctx.count[i], num_threads);
+        }
+    }
+}
+
+void parallel_for_negative_threads(void) {
+    // Any count below one runs everything on the calling thread
+    test_ctx ctx = {{0}};
+    parallel_for(record_task, &ctx, NUM_TASKS, -1);
+    for (int i = 0; i < NUM_TASKS; i++) {
+        TEST_CHECK(1 == ctx.count[i]);
+        TEST_CHECK(0 == ctx.thread[i]);
+    }
+}
+
+void parallel_for_is_deterministic(void) {
+    // Tasks are assigned to threads in contiguous, ordered blocks
+    int num_threads = 7;
+    test_ctx ctx = {{0}};
+    parallel_for(record_task, &ctx, NUM_TASKS, num_threads);
+    TEST_CHECK(0 == ctx.thread[0]);
+    TEST_CHECK(num_threads - 1 == ctx.thread[NUM_TASKS - 1]);
+    for (int i = 1; i < NUM_TASKS; i++) {
+        TEST_CHECK(ctx.thread[i] == ctx.thread[i - 1] || ctx.thread[i] == ctx.thread[i - 1] + 1);
+    }
+}
+
+void parallel_for_no_tasks(void) {
+    test_ctx ctx = {{0}};
+    parallel_for(record_task, &ctx, 0, 4);
+    for (int i = 0; i < NUM_TASKS; i++) {
+        TEST_CHECK(0 == ctx.count[i]);
+    }
+}
+
+TEST_LIST = {
+    {"PARALLEL_TEST", title},
+    {"parallel_num_threads_works", parallel_num_threads_works},
+    {"parallel_for_runs_every_task_once", parallel_for_runs_every_task_once},
+    {"parallel_for_negative_threads", parallel_for_negative_threads},
+    {"parallel_for_is_deterministic", parallel_for_is_deterministic},
+    {"parallel_for_no_tasks", parallel_for_no_tasks},
+    {NULL, NULL} /* zero record marks the end of the list */
+};
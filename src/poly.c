@@ -85,7 +85,7 @@ C_KZG_RET new_poly_long_div(poly *out, const poly *dividend, const poly *divisor
     uint64_t a_pos = dividend->length - 1;
     uint64_t b_pos = divisor->length - 1;
     uint64_t diff = a_pos - b_pos;
-    fr_t a[dividend->length];
+    fr_t a[dividend->length], inv_lead;
 
     // Dividing by zero is undefined
     CHECK(divisor->length > 0);
@@ -100,8 +100,11 @@ C_KZG_RET new_poly_long_div(poly *out, const poly *dividend, const poly *divisor
         a[i] = dividend->coeffs[i];
     }
 
+    // Every step divides by the divisor's leading coefficient, so invert it just once
+    fr_inv(&inv_lead, &divisor->coeffs[b_pos]);
+
     while (diff > 0) {
-        fr_div(&out->coeffs[diff], &a[a_pos], &divisor->coeffs[b_pos]);
+        fr_mul(&out->coeffs[diff], &a[a_pos], &inv_lead);
         for (uint64_t i = 0; i <= b_pos; i++) {
             fr_t tmp;
             // a[diff + i] -= b[i] * quot
@@ -111,7 +114,7 @@ C_KZG_RET new_poly_long_div(poly *out, const poly *dividend, const poly *divisor
         --diff;
         --a_pos;
     }
-    fr_div(&out->coeffs[0], &a[a_pos], &divisor->coeffs[b_pos]);
+    fr_mul(&out->coeffs[0], &a[a_pos], &inv_lead);
 
     return C_KZG_OK;
 }
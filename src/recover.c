@@ -26,50 +26,6 @@
 #include "utility.h"
 #include "zero_poly.h"
 
-/** 5 is a primitive element, but actually this can be pretty much anything not 0 or a low-degree root of unity */
-#define SCALE_FACTOR 5
-
-/**
- * Scale a polynomial in place.
- *
- * Multiplies each coefficient by `1 / scale_factor ^ i`. Equivalent to creating a polynomial that evaluates at `x * k`
- * rather than `x`.
- *
- * @param[out,in] p The polynomial coefficients to be scaled
- * @param[in] len_p Length of the polynomial coefficients
- */
-void scale_poly(fr_t *p, uint64_t len_p) {
-    fr_t scale_factor, factor_power, inv_factor;
-    fr_from_uint64(&scale_factor, SCALE_FACTOR);
-    fr_inv(&inv_factor, &scale_factor);
-    factor_power = fr_one;
-
-    for (uint64_t i = 1; i < len_p; i++) {
-        fr_mul(&factor_power, &factor_power, &inv_factor);
-        fr_mul(&p[i], &p[i], &factor_power);
-    }
-}
-
-/**
- * Unscale a polynomial in place.
- *
- * Multiplies each coefficient by `scale_factor ^ i`. Equivalent to creating a polynomial that evaluates at `x / k`
- * rather than `x`.
- *
- * @param[out,in] p The polynomial coefficients to be unscaled
- * @param[in] len_p Length of the polynomial coefficients
- */
-void unscale_poly(fr_t *p, uint64_t len_p) {
-    fr_t scale_factor, factor_power;
-    fr_from_uint64(&scale_factor, SCALE_FACTOR);
-    factor_power = fr_one;
-
-    for (uint64_t i = 1; i < len_p; i++) {
-        fr_mul(&factor_power, &factor_power, &scale_factor);
-        fr_mul(&p[i], &p[i], &factor_power);
-    }
-}
-
 /**
  * Given a dataset with up to half the entries missing, return the reconstructed original.
  *
@@ -77,6 +33,9 @@ void unscale_poly(fr_t *p, uint64_t len_p) {
  *
  * See https://ethresear.ch/t/reed-solomon-erasure-code-recovery-in-n-log-2-n-time-with-ffts/3039
  *
+ * @remark The division is done with FFTs over the coset shifted by #SCALE_FACTOR, whose powers are taken from @p fs
+ * when they have been cached there with #precompute_fft_coset.
+ *
  * @param[out] reconstructed_data An attempted reconstruction of the original data
  * @param[in]  samples            The data to be reconstructed, with `fr_null` set for missing values
  * @param[in]  len_samples        The length of @p samples and @p reconstructed_data
@@ -90,15 +49,11 @@ C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uin
 
     CHECK(is_power_of_two(len_samples));
 
-    uint64_t *missing;
+    uint64_t *missing, *zeros;
     TRY(new_uint64_array(&missing, len_samples));
+    TRY(new_uint64_array(&zeros, len_samples));
 
-    uint64_t len_missing = 0;
-    for (uint64_t i = 0; i < len_samples; i++) {
-        if (fr_is_null(&samples[i])) {
-            missing[len_missing++] = i;
-        }
-    }
+    uint64_t len_missing = fr_find_null(missing, samples, len_samples);
 
     // Make scratch areas, each of size len_samples. Cuts space required by 57%.
     fr_t *scratch;
@@ -113,7 +68,6 @@ C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uin
     fr_t *poly_with_zero = scratch0;
     fr_t *eval_scaled_poly_with_zero = scratch2;
     fr_t *eval_scaled_zero_poly = scratch0;
-    fr_t *scaled_reconstructed_poly = scratch1;
 
     poly zero_poly;
     zero_poly.length = len_samples;
@@ -122,9 +76,10 @@ C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uin
     // Calculate `Z_r,I`
     TRY(zero_polynomial_via_multiplication(zero_eval, &zero_poly, len_samples, missing, len_missing, fs));
 
-    // Check all is well
-    for (uint64_t i = 0; i < len_samples; i++) {
-        TRY(fr_is_null(&samples[i]) == fr_is_zero(&zero_eval[i]) ? C_KZG_OK : C_KZG_ERROR);
+    // Check all is well: the zero polynomial should vanish at exactly the missing positions
+    TRY(fr_find_zero(zeros, zero_eval, len_samples) == len_missing ? C_KZG_OK : C_KZG_ERROR);
+    for (uint64_t i = 0; i < len_missing; i++) {
+        TRY(zeros[i] == missing[i] ? C_KZG_OK : C_KZG_ERROR);
     }
 
     // Construct E * Z_r,I: the loop makes the evaluation polynomial
@@ -135,38 +90,32 @@ C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uin
             fr_mul(&poly_evaluations_with_zero[i], &samples[i], &zero_eval[i]);
         }
     }
-    // Now inverse FFT so that poly_with_zero is (E * Z_r,I)(x) = (D * Z_r,I)(x)
-    TRY(fft_fr(poly_with_zero, poly_evaluations_with_zero, true, len_samples, fs));
-
-    // x -> k * x
-    scale_poly(poly_with_zero, len_samples);
-    scale_poly(zero_poly.coeffs, zero_poly.length);
+    // Now inverse FFT so that poly_with_zero is (E * Z_r,I)(x) = (D * Z_r,I)(x). Its coefficients are left in
+    // bit-reversed order, which the next FFT takes as is, so the pair needs no permutations.
+    TRY(fft_fr_dif(poly_with_zero, poly_evaluations_with_zero, true, len_samples, NULL, fs));
 
-    // Q1 = (D * Z_r,I)(k * x)
-    fr_t *scaled_poly_with_zero = poly_with_zero; // Renaming
-    // Q2 = Z_r,I(k * x)
-    fr_t *scaled_zero_poly = zero_poly.coeffs; // Renaming
+    // Polynomial division by convolution: Q3 = Q1 / Q2, where Q1 = (D * Z_r,I)(k * x) and Q2 = Z_r,I(k * x). The
+    // coset FFTs evaluate at k * x directly.
+    fr_t scale_factor;
+    fr_from_uint64(&scale_factor, SCALE_FACTOR);
+    TRY(fft_fr_dit(eval_scaled_poly_with_zero, poly_with_zero, false, len_samples, &scale_factor, fs));
+    TRY(fft_fr_coset(eval_scaled_zero_poly, zero_poly.coeffs, false, len_samples, &scale_factor, fs));
 
-    // Polynomial division by convolution: Q3 = Q1 / Q2
-    TRY(fft_fr(eval_scaled_poly_with_zero, scaled_poly_with_zero, false, len_samples, fs));
-    TRY(fft_fr(eval_scaled_zero_poly, scaled_zero_poly, false, len_samples, fs));
+    // Invert all the divisors at once, using scratch1 which is free until the next FFT
+    fr_t *inv_eval_scaled_zero_poly = scratch1;
+    fr_batch_inv(inv_eval_scaled_zero_poly, eval_scaled_zero_poly, len_samples);
 
     fr_t *eval_scaled_reconstructed_poly = eval_scaled_poly_with_zero;
-    for (uint64_t i = 0; i < len_samples; i++) {
-        fr_div(&eval_scaled_reconstructed_poly[i], &eval_scaled_poly_with_zero[i], &eval_scaled_zero_poly[i]);
-    }
-
-    // The result of the division is D(k * x):
-    TRY(fft_fr(scaled_reconstructed_poly, eval_scaled_reconstructed_poly, true, len_samples, fs));
-
-    // k * x -> x
-    unscale_poly(scaled_reconstructed_poly, len_samples);
+    fr_vec_mul(eval_scaled_reconstructed_poly, eval_scaled_poly_with_zero, inv_eval_scaled_zero_poly, len_samples);
 
-    // Finally we have D(x) which evaluates to our original data at the powers of roots of unity
-    fr_t *reconstructed_poly = scaled_reconstructed_poly; // Renaming
+    // The result of the division is D(k * x), and the inverse coset FFT takes k * x -> x. Finally we have D(x) which
+    // evaluates to our original data at the powers of roots of unity. Again, the coefficients in between are in
+    // bit-reversed order.
+    fr_t *reconstructed_poly = scratch1;
+    TRY(fft_fr_dif(reconstructed_poly, eval_scaled_reconstructed_poly, true, len_samples, &scale_factor, fs));
 
     // The evaluation polynomial for D(x) is the reconstructed data:
-    TRY(fft_fr(reconstructed_data, reconstructed_poly, false, len_samples, fs));
+    TRY(fft_fr_dit(reconstructed_data, reconstructed_poly, false, len_samples, NULL, fs));
 
     // Check all is well
     for (uint64_t i = 0; i < len_samples; i++) {
@@ -175,6 +124,7 @@ C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uin
 
     free(scratch);
     free(missing);
+    free(zeros);
 
     return C_KZG_OK;
 }
\ No newline at end of file
@@ -19,4 +19,12 @@
 #include "c_kzg.h"
 #include "fft_common.h"
 
+/**
+ * The coset shift used by #recover_poly_from_samples.
+ *
+ * 5 is a primitive element, but actually this can be pretty much anything not 0 or a low-degree root of unity. The
+ * FFTs are faster if the powers of this shift are cached in the FFT settings with #precompute_fft_coset.
+ */
+#define SCALE_FACTOR 5
+
 C_KZG_RET recover_poly_from_samples(fr_t *reconstructed_data, fr_t *samples, uint64_t len_samples, FFTSettings *fs);
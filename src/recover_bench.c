@@ -28,8 +28,11 @@ long run_bench(int scale, int max_seconds) {
     timespec_t t0, t1;
     unsigned long total_time = 0, nits = 0;
     FFTSettings fs;
+    fr_t scale_factor;
 
     assert(C_KZG_OK == new_fft_settings(&fs, scale));
+    fr_from_uint64(&scale_factor, SCALE_FACTOR);
+    assert(C_KZG_OK == precompute_fft_coset(&fs, &scale_factor));
 
     // Allocate on the heap to avoid stack overflow for large sizes
     fr_t *poly = malloc(fs.max_width * sizeof(fr_t));
@@ -102,6 +102,8 @@ uint32_t reverse_bits(uint32_t a) {
  * @return The reversal of the lowest log_2(@p n) bits of the input @p value
  */
 uint32_t reverse_bits_limited(uint32_t n, uint32_t value) {
+    // There are no bits to reverse, and shifting by 32 would be undefined
+    if (n == 1) return 0;
     int unused_bit_len = 32 - log2_pow2(n);
     return reverse_bits(value) >> unused_bit_len;
 }
@@ -98,6 +98,18 @@ void test_reverse_bits_random(void) {
     }
 }
 
+void test_reverse_bits_limited(void) {
+    TEST_CHECK(0 == reverse_bits_limited(1, 0));
+    TEST_CHECK(0 == reverse_bits_limited(2, 0));
+    TEST_CHECK(1 == reverse_bits_limited(2, 1));
+    TEST_CHECK(4 == reverse_bits_limited(8, 1));
+    TEST_CHECK(3 == reverse_bits_limited(8, 6));
+    for (int i = 0; i < 32; i++) {
+        uint32_t n = (uint32_t)1 << i;
+        TEST_CHECK(reverse_bits_limited(n, n - 1) == n - 1);
+    }
+}
+
 void test_reverse_bit_order_g1(void) {
     int size = 10, n = 1 << size;
     g1_t a[n], b[n];
@@ -175,6 +187,7 @@ TEST_LIST = {
     {"test_reverse_bits_macros", test_reverse_bits_macros},
     {"test_reverse_bits_powers", test_reverse_bits_powers},
     {"test_reverse_bits_random", test_reverse_bits_random},
+    {"test_reverse_bits_limited", test_reverse_bits_limited},
     {"test_reverse_bit_order_g1", test_reverse_bit_order_g1},
     {"test_reverse_bit_order_fr", test_reverse_bit_order_fr},
     {"test_reverse_bit_order_fr_large", test_reverse_bit_order_fr_large},
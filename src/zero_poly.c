@@ -46,11 +46,13 @@ C_KZG_RET do_zero_poly_mul_partial(poly *dst, const uint64_t *indices, uint64_t
     CHECK(len_indices > 0);
     CHECK(dst->length >= len_indices + 1);
 
-    fr_negate(&dst->coeffs[0], &fs->expanded_roots_of_unity[indices[0] * stride]);
+    fft_root_of_unity(&dst->coeffs[0], fs, false, indices[0] * stride);
+    fr_negate(&dst->coeffs[0], &dst->coeffs[0]);
 
     for (uint64_t i = 1; i < len_indices; i++) {
         fr_t neg_di;
-        fr_negate(&neg_di, &fs->expanded_roots_of_unity[indices[i] * stride]);
+        fft_root_of_unity(&neg_di, fs, false, indices[i] * stride);
+        fr_negate(&neg_di, &neg_di);
         dst->coeffs[i] = neg_di;
         fr_add(&dst->coeffs[i], &dst->coeffs[i], &dst->coeffs[i - 1]);
         for (uint64_t j = i - 1; j > 0; j--) {
@@ -94,13 +96,14 @@ C_KZG_RET pad_p(fr_t *out, uint64_t out_len, const poly *p) {
 /**
  * Calculate the product of the input polynomials via convolution.
  *
- * Pad the polynomials in @p ps, perform FFTs, point-wise multiply the results together, and apply an inverse FFT to the
- * result.
+ * Perform FFTs of the polynomials in @p partials, as if padded with zeros, point-wise multiply the results together,
+ * and apply an inverse FFT to the result. The FFTs are pruned with #fft_fr_pruned to skip the zero padding of the
+ * inputs and the zero coefficients of the output beyond its degree.
  *
  * @param[out] out         Polynomial with @p len_out space allocated. The length will be set on return.
  * @param[in]  len_out     Length of the domain of evaluation, a power of two
- * @param      scratch     Scratch space of size at least 3 times the @p len_out
- * @param[in]  len_scratch Length of @p scratch, at least 3 times @p len_out
+ * @param      scratch     Scratch space of size at least 2 times the @p len_out
+ * @param[in]  len_scratch Length of @p scratch, at least 2 times @p len_out
  * @param[in]  partials    Array of polynomials to be multiplied together
  * @param[in]  partial_count The number of polynomials to be multiplied together
  * @param[in]  fs          The FFT settings previously initialised with #new_fft_settings
@@ -111,7 +114,7 @@ C_KZG_RET pad_p(fr_t *out, uint64_t out_len, const poly *p) {
 C_KZG_RET reduce_partials(poly *out, uint64_t len_out, fr_t *scratch, uint64_t len_scratch, const poly *partials,
                           uint64_t partial_count, const FFTSettings *fs) {
     CHECK(is_power_of_two(len_out));
-    CHECK(len_scratch >= 3 * len_out);
+    CHECK(len_scratch >= 2 * len_out);
     CHECK(partial_count > 0);
     // The degree of the output polynomial is the sum of the degrees of the input polynomials.
     uint64_t out_degree = 0;
@@ -120,24 +123,23 @@ C_KZG_RET reduce_partials(poly *out, uint64_t len_out, fr_t *scratch, uint64_t l
     }
     CHECK(out_degree + 1 <= len_out);
 
-    // Split `scratch` up into three equally sized working arrays
-    fr_t *p_padded = scratch;
-    fr_t *mul_eval_ps = scratch + len_out;
-    fr_t *p_eval = scratch + 2 * len_out;
+    // Split `scratch` up into two equally sized working arrays
+    fr_t *mul_eval_ps = scratch;
+    fr_t *p_eval = scratch + len_out;
 
-    // Do the last partial first: it is no longer than the others and the padding can remain in place for the rest.
-    TRY(pad_p(p_padded, len_out, &partials[partial_count - 1]));
-    TRY(fft_fr(mul_eval_ps, p_padded, false, len_out, fs));
+    // The partials are transformed without padding them, since the pruned FFT skips the zeros
+    TRY(fft_fr_pruned(mul_eval_ps, partials[0].coeffs, false, len_out, partials[0].length, len_out, fs));
 
-    for (uint64_t i = 0; i < partial_count - 1; i++) {
-        TRY(pad_p(p_padded, partials[i].length, &partials[i]));
-        TRY(fft_fr(p_eval, p_padded, false, len_out, fs));
-        for (uint64_t j = 0; j < len_out; j++) {
-            fr_mul(&mul_eval_ps[j], &mul_eval_ps[j], &p_eval[j]);
-        }
+    for (uint64_t i = 1; i < partial_count; i++) {
+        TRY(fft_fr_pruned(p_eval, partials[i].coeffs, false, len_out, partials[i].length, len_out, fs));
+        fr_vec_mul(mul_eval_ps, mul_eval_ps, p_eval, len_out);
     }
 
-    TRY(fft_fr(out->coeffs, mul_eval_ps, true, len_out, fs));
+    // Only the coefficients up to the degree of the product are needed, the rest being zero
+    TRY(fft_fr_pruned(out->coeffs, mul_eval_ps, true, len_out, len_out, out_degree + 1, fs));
+    for (uint64_t i = out_degree + 1; i < len_out; i++) {
+        out->coeffs[i] = fr_zero;
+    }
     out->length = out_degree + 1;
 
     return C_KZG_OK;
@@ -194,7 +196,7 @@ C_KZG_RET zero_polynomial_via_multiplication(fr_t *zero_eval, poly *zero_poly, u
     if (len_missing <= missing_per_partial) {
 
         TRY(do_zero_poly_mul_partial(zero_poly, missing_indices, len_missing, domain_stride, fs));
-        TRY(fft_fr(zero_eval, zero_poly->coeffs, false, length, fs));
+        TRY(fft_fr_pruned(zero_eval, zero_poly->coeffs, false, length, zero_poly->length, length, fs));
 
     } else {
 
@@ -223,7 +225,7 @@ C_KZG_RET zero_polynomial_via_multiplication(fr_t *zero_eval, poly *zero_poly, u
         // Reduce all the partials to a single polynomial
         int reduction_factor = 4; // must be a power of 2 (for sake of the FFTs in reduce_partials)
         fr_t *scratch;
-        TRY(new_fr_array(&scratch, n * 3));
+        TRY(new_fr_array(&scratch, n * 2));
         while (partial_count > 1) {
             uint64_t reduced_count = (partial_count + reduction_factor - 1) / reduction_factor;
             uint64_t partial_size = next_power_of_two(partials[0].length);
@@ -234,7 +236,7 @@ C_KZG_RET zero_polynomial_via_multiplication(fr_t *zero_eval, poly *zero_poly, u
                 uint64_t partials_num = min_u64(reduction_factor, partial_count - start);
                 partials[i].coeffs = work + start * partial_size;
                 if (partials_num > 1) {
-                    TRY(reduce_partials(&partials[i], reduced_len, scratch, n * 3, &partials[start], partials_num, fs));
+                    TRY(reduce_partials(&partials[i], reduced_len, scratch, n * 2, &partials[start], partials_num, fs));
                 } else {
                     partials[i].length = partials[start].length;
                 }
@@ -244,7 +246,7 @@ C_KZG_RET zero_polynomial_via_multiplication(fr_t *zero_eval, poly *zero_poly, u
 
         // Process final output
         TRY(pad_p(zero_poly->coeffs, length, &partials[0]));
-        TRY(fft_fr(zero_eval, zero_poly->coeffs, false, length, fs));
+        TRY(fft_fr_pruned(zero_eval, zero_poly->coeffs, false, length, partials[0].length, length, fs));
 
         zero_poly->length = partials[0].length;
 
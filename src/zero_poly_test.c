@@ -179,8 +179,9 @@ void check_test_data(void) {
     // Polynomial evalutes to zero at the expected places
     for (int i = 0; i < 16; i++) {
         if (!exists[i]) {
-            fr_t tmp;
-            eval_poly(&tmp, &expected_poly, &fs.expanded_roots_of_unity[i]);
+            fr_t tmp, x;
+            fft_root_of_unity(&x, &fs, false, i);
+            eval_poly(&tmp, &expected_poly, &x);
             TEST_CHECK(fr_is_zero(&tmp));
             TEST_MSG("Failed for i = %d", i);
         }
@@ -188,8 +189,9 @@ void check_test_data(void) {
 
     // This is a curiosity
     for (int i = 1; i < 8; i++) {
-        fr_t tmp;
-        eval_poly(&tmp, &expected_eval, &fs.expanded_roots_of_unity[i]);
+        fr_t tmp, x;
+        fft_root_of_unity(&x, &fs, false, i);
+        eval_poly(&tmp, &expected_eval, &x);
         TEST_CHECK(fr_is_zero(&tmp));
         TEST_MSG("Failed for i = %d", i);
     }
@@ -279,8 +281,9 @@ void zero_poly_random(void) {
 
             int ret = 0;
             for (int i = 0; i < len_missing; i++) {
-                fr_t out;
-                eval_poly(&out, &zero_poly, &fs.expanded_roots_of_unity[missing[i]]);
+                fr_t out, x;
+                fft_root_of_unity(&x, &fs, false, missing[i]);
+                eval_poly(&out, &zero_poly, &x);
                 ret = TEST_CHECK(fr_is_zero(&out));
                 TEST_MSG("Failed for missing[%d] = %lu", i, missing[i]);
             }
@@ -330,8 +333,9 @@ void zero_poly_all_but_one(void) {
 
     int ret = 0;
     for (int i = 0; i < len_missing; i++) {
-        fr_t out;
-        eval_poly(&out, &zero_poly, &fs.expanded_roots_of_unity[missing[i]]);
+        fr_t out, x;
+        fft_root_of_unity(&x, &fs, false, missing[i]);
+        eval_poly(&out, &zero_poly, &x);
         ret = TEST_CHECK(fr_is_zero(&out));
         TEST_MSG("Failed for missing[%d] = %lu", i, missing[i]);
     }
@@ -378,8 +382,9 @@ void zero_poly_252(void) {
 
     int ret = 0;
     for (int i = 0; i < len_missing; i++) {
-        fr_t out;
-        eval_poly(&out, &zero_poly, &fs.expanded_roots_of_unity[missing[i]]);
+        fr_t out, x;
+        fft_root_of_unity(&x, &fs, false, missing[i]);
+        eval_poly(&out, &zero_poly, &x);
         ret = TEST_CHECK(fr_is_zero(&out));
         TEST_MSG("Failed for missing[%d] = %lu", i, missing[i]);
     }